@@ -11,13 +11,61 @@
 
 namespace fredemmott::inputmapping {
 
-AxisCurve::AxisCurve(double curviness) : mCurviness(curviness) {
+namespace {
+const int64_t FIXED_ONE = int64_t {1} << 30;
+// Beyond this, rounding the curviness to 30 bits can be visible in the output
+const double MAX_FIXED_CURVINESS = 0.9999;
+}// namespace
+
+AxisCurve::AxisCurve(double curviness)
+  : mCurviness(curviness),
+    mFixedCurviness(0),
+    mFixedPoint(std::abs(curviness) <= MAX_FIXED_CURVINESS) {
+  if (mFixedPoint) {
+    mFixedCurviness = std::llround(curviness * FIXED_ONE);
+  }
 }
 
 AxisCurve::~AxisCurve() {
 }
 
 void AxisCurve::map(long value) {
+  if (mFixedPoint) {
+    mapFixedPoint(value);
+    return;
+  }
+  mapFloatingPoint(value);
+}
+
+void AxisCurve::mapFixedPoint(long value) {
+  // Out of range values would otherwise make the denominator zero or
+  // negative
+  value = value < Axis::MIN ? Axis::MIN
+                            : (value > Axis::MAX ? Axis::MAX : value);
+
+  // As mapFloatingPoint(), but multiplied through by the scale, so that
+  //
+  //   |f(x)| * scale = |d| * scale * (1 - k) / (scale * (1 + k) - 2 * k * |d|)
+  //
+  // ... where d is the offset from the midpoint. The denominator is always
+  // positive for -1 < k < 1, and the numerator fits in 62 bits.
+  const uint64_t scale = value > 0x7fff ? 0x8000 : 0x7fff;
+  const bool negative = value < 0x7fff;
+  const uint64_t d = negative ? 0x7fff - value : value - 0x7fff;
+  const int64_t k = mFixedCurviness;
+
+  const uint64_t numerator = d * scale * (FIXED_ONE - k);
+  const uint64_t denominator = (scale * (FIXED_ONE + k)) - (2 * k * d);
+  // Round towards negative infinity, like the conversion from double does
+  // once the midpoint has been added back
+  const auto fx = negative ? (numerator + denominator - 1) / denominator
+                           : numerator / denominator;
+  const auto clamped = static_cast<long>(fx > scale ? scale : fx);
+
+  emit(negative ? 0x7fff - clamped : 0x7fff + clamped);
+}
+
+void AxisCurve::mapFloatingPoint(long value) {
   // Normalize between -1 to 1
   //
   // the raw range is 0-0xffff with 0x7fff as 'neutral', which means
@@ -32,11 +80,11 @@ void AxisCurve::map(long value) {
   const double k = mCurviness;
   // This is based on
   // https://dinodini.wordpress.com/2010/04/05/normalized-tunable-sigmoid-functions/
-  const auto fx = (x - (x * k)) / (k - (abs(x) * 2 * k) + 1);
+  const auto fx = (x - (x * k)) / (k - (std::abs(x) * 2 * k) + 1);
 
   const auto clamped = fx > 1.0 ? 1.0 : (fx < -1.0 ? -1.0 : fx);
 
-  emit((clamped * scale) + 0x7fff);
+  emit(static_cast<long>((clamped * scale) + 0x7fff));
 }
 
 }// namespace fredemmott::inputmapping
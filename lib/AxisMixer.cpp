@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/AxisMixer.h>
+#include <cpp-remapper/DispatchContext.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+
+// Coefficients are 16.16 fixed-point, stored in 32 bits
+const int FIXED_POINT_BITS = 16;
+const double MAX_COEFFICIENT = (1 << (31 - FIXED_POINT_BITS)) - 1;
+
+void validate(const std::vector<AxisMixer::Output>& outputs) {
+  if (outputs.empty()) {
+    throw std::invalid_argument("AxisMixer needs at least one output");
+  }
+  const auto inputCount = outputs.front().coefficients.size();
+  if (inputCount == 0) {
+    throw std::invalid_argument("AxisMixer needs at least one input");
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    const auto& output = outputs[i];
+    if (output.coefficients.size() != inputCount) {
+      throw std::invalid_argument(std::format(
+        "AxisMixer output {} has {} coefficients, but output 0 has {}",
+        i,
+        output.coefficients.size(),
+        inputCount));
+    }
+    for (const auto coefficient: output.coefficients) {
+      // Also rejects NaN
+      if (!(std::abs(coefficient) <= MAX_COEFFICIENT)) {
+        throw std::invalid_argument(std::format(
+          "AxisMixer output {} has coefficient {}, but they must be between "
+          "-{} and {}",
+          i,
+          coefficient,
+          MAX_COEFFICIENT,
+          MAX_COEFFICIENT));
+      }
+    }
+    if (
+      output.min < Axis::MIN || output.max > Axis::MAX
+      || output.min > output.max) {
+      throw std::invalid_argument(std::format(
+        "AxisMixer output {} has an invalid range ({} to {})",
+        i,
+        output.min,
+        output.max));
+    }
+  }
+}
+
+}// namespace
+
+struct AxisMixer::State {
+  class Input final : public Sink<Axis> {
+   public:
+    Input(State* state, size_t index) : mState(state), mIndex(index) {
+    }
+
+    virtual void map(Axis::Value value) override {
+      mState->values[mIndex] = static_cast<int32_t>(value);
+      mState->deferredUpdate.request();
+    }
+
+   private:
+    State* mState;
+    size_t mIndex;
+  };
+
+  const size_t inputCount;
+  const size_t outputCount;
+
+  // Column-major - all the coefficients for the first input, then the
+  // second, and so on - so that each input is one pass over contiguous
+  // coefficients and accumulators.
+  //
+  // Coefficients and values are 32-bit, and accumulators 64-bit: compilers
+  // can vectorize that widening multiply-add (e.g. with SSE4.1's `pmuldq`),
+  // but generally not a 64x64-bit multiply.
+  std::vector<int32_t> coefficients;
+  // Offsets, pre-shifted and with rounding
+  std::vector<int64_t> initial;
+  std::vector<int64_t> accumulators;
+  std::vector<Axis::Value> mins;
+  std::vector<Axis::Value> maxes;
+
+  std::vector<int32_t> values;
+  std::vector<Axis::Value> emitted;
+
+  std::vector<Input> inputs;
+  std::vector<OutputSource<Axis>> outputs;
+
+  // Several inputs often change in the same poll; only update once
+  DispatchContext::DeferredUpdate deferredUpdate {[this]() { update(); }};
+
+  State(const std::vector<Output>& config)
+    : inputCount(config.front().coefficients.size()),
+      outputCount(config.size()),
+      coefficients(inputCount * outputCount),
+      initial(outputCount),
+      accumulators(outputCount),
+      mins(outputCount),
+      maxes(outputCount),
+      values(inputCount, Axis::MID),
+      // Not a valid value, so the first update emits everything
+      emitted(outputCount, -1),
+      outputs(outputCount) {
+    const int64_t one = int64_t {1} << FIXED_POINT_BITS;
+    for (size_t out = 0; out < outputCount; ++out) {
+      const auto& output = config[out];
+      for (size_t in = 0; in < inputCount; ++in) {
+        coefficients[(in * outputCount) + out] = static_cast<int32_t>(
+          std::lround(output.coefficients[in] * one));
+      }
+      initial[out] = (output.offset * one) + (one / 2);
+      mins[out] = output.min;
+      maxes[out] = output.max;
+    }
+    // `Input`s must not move, as they're pointed to by `Inputs`
+    inputs.reserve(inputCount);
+    for (size_t in = 0; in < inputCount; ++in) {
+      inputs.emplace_back(this, in);
+    }
+  }
+
+  void update() {
+    // Copied, as `acc` could alias the members as far as the compiler
+    // knows, which stops it from vectorizing
+    const auto ins = inputCount;
+    const auto outs = outputCount;
+    const auto inputValues = values.data();
+    const auto matrix = coefficients.data();
+    auto acc = accumulators.data();
+    std::copy(initial.begin(), initial.end(), acc);
+    for (size_t in = 0; in < ins; ++in) {
+      const auto value = inputValues[in];
+      const auto column = &matrix[in * outs];
+      for (size_t out = 0; out < outs; ++out) {
+        acc[out] += int64_t {column[out]} * value;
+      }
+    }
+
+    for (size_t out = 0; out < outputCount; ++out) {
+      // Rounds to nearest, as `initial` includes a half
+      const auto mixed = acc[out] >> FIXED_POINT_BITS;
+      const auto clamped = static_cast<Axis::Value>(
+        mixed < mins[out] ? mins[out]
+                          : (mixed > maxes[out] ? maxes[out] : mixed));
+      if (clamped == emitted[out]) {
+        continue;
+      }
+      emitted[out] = clamped;
+      outputs[out].emit(clamped);
+    }
+  }
+};
+
+AxisMixer::AxisMixer(const std::vector<Output>& outputs) {
+  validate(outputs);
+  p = std::make_shared<State>(outputs);
+  for (auto& input: p->inputs) {
+    Inputs.push_back(std::shared_ptr<Sink<Axis>>(p, &input));
+  }
+  for (auto& output: p->outputs) {
+    Outputs.push_back(std::shared_ptr<Source<Axis>>(p, &output));
+  }
+}
+
+AxisMixer::~AxisMixer() {
+}
+
+}// namespace fredemmott::inputmapping
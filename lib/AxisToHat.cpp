@@ -9,13 +9,132 @@
 #define _USE_MATH_DEFINES
 #include <cpp-remapper/AxisToHat.h>
 
+#include <array>
 #include <cmath>
+#include <cstdlib>
 
 namespace fredemmott::inputmapping {
 
+namespace {
+
+// Centidegrees are rounded to the nearest whole number; the boundaries
+// between them in the first octant (0-45 degrees) are at 0.5, 1.5, ...
+// 4499.5 centidegrees, stored as tan(angle) in fixed point.
+const int OCTANT_CENTIDEGREES = 4500;
+const int FIXED_POINT_BITS = 48;
+// Where to start searching the boundaries, indexed by the top bits of the
+// tangent, so that only one or two boundaries need to be compared
+const int BUCKET_BITS = 12;
+
+struct OctantTables {
+  std::array<uint64_t, OCTANT_CENTIDEGREES> boundaries;
+  std::array<uint16_t, (1 << BUCKET_BITS) + 1> firstBoundary;
+};
+
+const OctantTables gOctantTables = [] {
+  OctantTables ret;
+  for (int i = 0; i < OCTANT_CENTIDEGREES; ++i) {
+    const double radians = ((i + 0.5) * M_PI) / 18000;
+    ret.boundaries[i] = static_cast<uint64_t>(
+      std::tan(radians) * static_cast<double>(1ull << FIXED_POINT_BITS));
+  }
+  int boundary = 0;
+  for (uint64_t bucket = 0; bucket < ret.firstBoundary.size(); ++bucket) {
+    const auto bucketStart = bucket << (FIXED_POINT_BITS - BUCKET_BITS);
+    while (boundary < OCTANT_CENTIDEGREES
+           && ret.boundaries[boundary] < bucketStart) {
+      ++boundary;
+    }
+    ret.firstBoundary[bucket] = static_cast<uint16_t>(boundary);
+  }
+  return ret;
+}();
+
+// atan(opposite / adjacent) in centidegrees, rounded to nearest, where
+// 0 <= opposite <= adjacent.
+int octant_centidegrees(uint64_t adjacent, uint64_t opposite) {
+  if (adjacent == 0) {
+    return 0;
+  }
+  const auto& tables = gOctantTables;
+  const auto bucket = (opposite << BUCKET_BITS) / adjacent;
+  const auto scaled = opposite << FIXED_POINT_BITS;
+  int centidegrees = tables.firstBoundary[bucket];
+  while (centidegrees < OCTANT_CENTIDEGREES
+         && scaled > tables.boundaries[centidegrees] * adjacent) {
+    ++centidegrees;
+  }
+  return centidegrees;
+}
+
+// Same as lround(18000 * atan2(y, x) / M_PI)
+int atan2_centidegrees(long x, long y) {
+  const uint64_t ax = std::labs(x);
+  const uint64_t ay = std::labs(y);
+  // Fold into the first octant; rounding is symmetric, so flipping around
+  // a whole number of centidegrees gives the same result
+  const int quadrant = (ay <= ax) ? octant_centidegrees(ax, ay)
+                                  : 9000 - octant_centidegrees(ay, ax);
+  if (x >= 0) {
+    return y >= 0 ? quadrant : -quadrant;
+  }
+  return y >= 0 ? 18000 - quadrant : quadrant - 18000;
+}
+
+}// namespace
+
 const Percent AxisToHat::DEFAULT_DEADZONE = 90_percent;
 
+AxisToHat::AxisInput::AxisInput(
+  AxisToHat* parent,
+  Axis::Value AxisToHat::*value)
+  : mParent(parent), mValue(value) {
+}
+
+void AxisToHat::AxisInput::map(Axis::Value value) {
+  mParent->*mValue = value;
+  mParent->update();
+}
+
 AxisToHat::AxisToHat(Percent deadzone) : mDeadzone(deadzone) {
+  // Treat deadzone as combined distance to center - same amount of
+  // needed for corners.
+  //
+  // Find the smallest squared distance that is outside of the deadzone, using
+  // the same floating-point comparison as before so that the boundary is
+  // exactly the same.
+  const auto inDeadzone = [threshold = mDeadzone.value() / 2](int64_t d2) {
+    const auto distance = std::sqrt(static_cast<double>(d2));
+    return (distance * 100) / Hat::CENTER < threshold;
+  };
+  int64_t low = 0;
+  int64_t high = 2 * (int64_t {Axis::MAX} * Axis::MAX) + 1;
+  while (low < high) {
+    const auto mid = low + ((high - low) / 2);
+    if (inDeadzone(mid)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  mMinSquaredDistance = low;
+}
+
+AxisToHat::AxisToHat(const AxisToHat& other)
+  : HatSource(other),
+    mDeadzone(other.mDeadzone),
+    mMinSquaredDistance(other.mMinSquaredDistance),
+    mX(other.mX),
+    mY(other.mY) {
+}
+
+AxisToHat& AxisToHat::operator=(const AxisToHat& other) {
+  HatSource::operator=(other);
+  mDeadzone = other.mDeadzone;
+  mMinSquaredDistance = other.mMinSquaredDistance;
+  mX = other.mX;
+  mY = other.mY;
+  return *this;
 }
 
 AxisToHat::~AxisToHat() {
@@ -23,19 +142,15 @@ AxisToHat::~AxisToHat() {
 
 void AxisToHat::update() {
   // Recenter around (0, 0)
-  const auto x = mX - Axis::MID;
-  const auto y = mY - Axis::MID;
+  const int64_t x = mX - Axis::MID;
+  const int64_t y = mY - Axis::MID;
 
-  // Treat deadzone as combined distance to center - same amount of
-  // needed for corners.
-  const auto distance = sqrt((x * x) + (y * y));
-  if ((distance * 100) / Hat::CENTER < mDeadzone.value() / 2) {
+  if ((x * x) + (y * y) < mMinSquaredDistance) {
     emit(Hat::CENTER);
     return;
   }
 
-  const auto radians = atan2(y, x);
-  const auto centidegrees = std::lround((18000 * radians) / M_PI) + 9000;
+  const auto centidegrees = atan2_centidegrees(x, y) + 9000;
   emit(centidegrees < 0 ? centidegrees + 36000 : centidegrees);
 }
 
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/Chords.h>
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/MappableInput.h>
+#include <cpp-remapper/SinkPtr.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+const std::chrono::milliseconds INJECTED_PRESS_DURATION(100);
+const size_t MAX_BUTTONS = 128;
+
+// One bit per button; compared a word at a time
+struct ButtonMask {
+  std::array<uint64_t, MAX_BUTTONS / 64> words {};
+
+  static ButtonMask of(uint8_t id) {
+    ButtonMask ret;
+    ret.words[(id - 1) / 64] = uint64_t {1} << ((id - 1) % 64);
+    return ret;
+  }
+
+  /// True if every button in `other` is also in this mask
+  bool contains(const ButtonMask& other) const {
+    return ((words[0] & other.words[0]) == other.words[0])
+      && ((words[1] & other.words[1]) == other.words[1]);
+  }
+
+  bool intersects(const ButtonMask& other) const {
+    return (words[0] & other.words[0]) || (words[1] & other.words[1]);
+  }
+
+  int count() const {
+    return std::popcount(words[0]) + std::popcount(words[1]);
+  }
+
+  void add(const ButtonMask& other) {
+    words[0] |= other.words[0];
+    words[1] |= other.words[1];
+  }
+
+  void remove(const ButtonMask& other) {
+    words[0] &= ~other.words[0];
+    words[1] &= ~other.words[1];
+  }
+
+  template <std::invocable<uint8_t> F>
+  void forEach(F&& f) const {
+    for (size_t i = 0; i < words.size(); ++i) {
+      for (auto word = words[i]; word; word &= word - 1) {
+        f(static_cast<uint8_t>((i * 64) + std::countr_zero(word) + 1));
+      }
+    }
+  }
+
+  bool operator==(const ButtonMask&) const = default;
+};
+}// namespace
+
+struct Chords::State {
+  struct Chord {
+    ButtonMask buttons;
+    int size;
+    std::shared_ptr<OutputSource<Button>> next;
+    bool active = false;
+  };
+
+  std::chrono::steady_clock::duration window;
+  // Most buttons first, so the first match is the best one
+  std::vector<Chord> chords;
+  // Buttons that are part of at least one chord
+  ButtonMask members;
+  std::array<std::shared_ptr<OutputSource<Button>>, MAX_BUTTONS> buttons;
+
+  // Buttons we're receiving events for
+  ButtonMask attached;
+  // Chord buttons pressed in the current window
+  ButtonMask pending;
+  // Passed on via `buttons`
+  ButtonMask forwarded;
+  // Part of a chord; ignored until released
+  ButtonMask consumed;
+
+  bool windowOpen = false;
+  uint64_t windowGeneration = 0;
+
+  static void press(const std::shared_ptr<State>& self, uint8_t id) {
+    const auto bit = ButtonMask::of(id);
+    if (!self->members.intersects(bit)) {
+      self->forward(id);
+      return;
+    }
+    self->pending.add(bit);
+
+    // Keep waiting only if a bigger chord could still match
+    for (const auto& chord: self->chords) {
+      const auto& buttons = chord.buttons;
+      if (buttons.contains(self->pending) && buttons != self->pending) {
+        self->openWindow(self);
+        return;
+      }
+    }
+    self->resolve();
+  }
+
+  void release(uint8_t id) {
+    const auto bit = ButtonMask::of(id);
+    // If it was pressed during the window, the output is only being pressed
+    // now; keep it pressed for a moment so that it isn't missed
+    const bool wasPending = pending.intersects(bit);
+    if (wasPending) {
+      resolve();
+    }
+    const auto finish = [=](const auto& next) {
+      if (!wasPending) {
+        next->emit(false);
+        return;
+      }
+      Clock::get()->setTimer(
+        INJECTED_PRESS_DURATION, [next]() { next->emit(false); });
+    };
+
+    if (consumed.intersects(bit)) {
+      consumed.remove(bit);
+      for (auto& chord: chords) {
+        if (chord.active && chord.buttons.intersects(bit)) {
+          chord.active = false;
+          finish(chord.next);
+        }
+      }
+      return;
+    }
+
+    if (forwarded.intersects(bit)) {
+      forwarded.remove(bit);
+      if (buttons[id - 1]) {
+        finish(buttons[id - 1]);
+      }
+    }
+  }
+
+  void openWindow(const std::shared_ptr<State>& self) {
+    if (windowOpen) {
+      return;
+    }
+    windowOpen = true;
+    Clock::get()->setTimer(
+      window,
+      [weak = std::weak_ptr(self), generation = ++windowGeneration]() {
+        auto state = weak.lock();
+        if (!state || !state->windowOpen) {
+          return;
+        }
+        if (state->windowGeneration != generation) {
+          return;
+        }
+        state->resolve();
+      });
+  }
+
+  void resolve() {
+    windowOpen = false;
+    for (auto& chord: chords) {
+      if (chord.active || !pending.contains(chord.buttons)) {
+        continue;
+      }
+      chord.active = true;
+      consumed.add(chord.buttons);
+      pending.remove(chord.buttons);
+      chord.next->emit(true);
+    }
+    pending.forEach([this](uint8_t id) { forward(id); });
+    pending = {};
+  }
+
+  void forward(uint8_t id) {
+    forwarded.add(ButtonMask::of(id));
+    if (buttons[id - 1]) {
+      buttons[id - 1]->emit(true);
+    }
+  }
+};
+
+namespace {
+std::vector<ButtonSourcePtr> get_buttons(const MappableInput& input) {
+  std::vector<ButtonSourcePtr> ret;
+  for (size_t i = 1; i <= input.getButtonCount(); ++i) {
+    ret.push_back(input.button(static_cast<uint8_t>(i)));
+  }
+  return ret;
+}
+}// namespace
+
+Chords::Chords(
+  const MappableInput& input,
+  std::chrono::steady_clock::duration window)
+  : Chords(get_buttons(input), window) {
+}
+
+Chords::Chords(
+  const std::vector<ButtonSourcePtr>& buttons,
+  std::chrono::steady_clock::duration window)
+  : mButtons(buttons), p(std::make_shared<State>()) {
+  p->window = window;
+}
+
+Chords::~Chords() {
+}
+
+ButtonSourcePtr Chords::chord(std::initializer_list<uint8_t> ids) {
+  ButtonMask buttons;
+  for (const auto id: ids) {
+    if (!isValidButton(id)) {
+      printf(
+        "WARNING: Attempted to use button %d of %zu in a chord. Ignoring.\n",
+        id,
+        mButtons.size());
+      continue;
+    }
+    attach(id);
+    buttons.add(ButtonMask::of(id));
+  }
+  if (buttons.count() == 0) {
+    // Would always match, so would be pressed and never released
+    printf(
+      "WARNING: Attempted to use a chord with no valid buttons. Ignoring.\n");
+    return std::make_shared<OutputSource<Button>>();
+  }
+
+  auto next = std::make_shared<OutputSource<Button>>();
+  State::Chord chord {buttons, buttons.count(), next};
+  p->members.add(buttons);
+  p->chords.insert(
+    std::ranges::upper_bound(
+      p->chords, chord.size, std::greater {}, &State::Chord::size),
+    chord);
+  return std::static_pointer_cast<ButtonSource>(next);
+}
+
+ButtonSourcePtr Chords::button(uint8_t id) {
+  if (!isValidButton(id)) {
+    printf(
+      "WARNING: Attempted to use button %d of %zu via chords. Ignoring.\n",
+      id,
+      mButtons.size());
+    return std::make_shared<OutputSource<Button>>();
+  }
+  attach(id);
+  auto& next = p->buttons[id - 1];
+  if (!next) {
+    next = std::make_shared<OutputSource<Button>>();
+  }
+  return std::static_pointer_cast<ButtonSource>(next);
+}
+
+bool Chords::isValidButton(uint8_t id) const {
+  return id > 0 && id <= mButtons.size() && id <= MAX_BUTTONS;
+}
+
+void Chords::attach(uint8_t id) {
+  const auto bit = ButtonMask::of(id);
+  if (p->attached.intersects(bit)) {
+    return;
+  }
+  p->attached.add(bit);
+  mButtons[id - 1]->setNext(
+    ButtonSinkPtr([state = p, id](Button::Value pressed) {
+      if (pressed) {
+        State::press(state, id);
+      } else {
+        state->release(id);
+      }
+    }));
+}
+
+}// namespace fredemmott::inputmapping
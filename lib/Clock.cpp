@@ -7,12 +7,11 @@
  */
 #include <cpp-remapper/Clock.h>
 
-#include <cpp-remapper/EventLoop.h>
-
 namespace fredemmott::inputmapping {
 
 namespace {
 std::shared_ptr<Clock> g_clock;
+Clock::TimerTarget g_timer_target = nullptr;
 }
 
 std::shared_ptr<Clock> Clock::get() {
@@ -34,7 +33,14 @@ std::chrono::steady_clock::time_point Clock::now() noexcept {
 void Clock::setTimer(
   const std::chrono::steady_clock::duration& duration,
   const std::function<void()>& handler) noexcept {
-  EventLoop::inject(duration, handler);
+  // Without an event loop, there's nothing to run the timer
+  if (g_timer_target) {
+    g_timer_target(duration, handler);
+  }
+}
+
+void Clock::setTimerTarget(TimerTarget target) {
+  g_timer_target = target;
 }
 
 }// namespace fredemmott::inputmapping
@@ -7,103 +7,78 @@
  */
 #include <cpp-remapper/Controls.h>
 #include <cpp-remapper/DS4Device.h>
-#include <cpp-remapper/ViGEmClient.h>
-#include <cpp-remapper/ViGEmTarget.h>
+#include <cpp-remapper/OutputConversions.h>
 
-#include <iostream>
+// The ViGEm backend is in DS4DriverBackend.cpp; this file does not depend
+// on ViGEm.
 
 namespace fredemmott::inputmapping {
 
-class DS4Device::Impl final
-  : public detail::ViGEmTarget<DS4_REPORT, DS4Device::Impl> {
+class DS4Device::Impl final {
  public:
-  static void initState(DS4_REPORT* state) {
-    DS4_REPORT_INIT(state);
-  }
-
-  static PVIGEM_TARGET allocTarget() {
-    return vigem_target_ds4_alloc();
-  }
-
-  static const char* productShortName() {
-    return "DS4 pad";
-  }
+  std::shared_ptr<Backend> backend;
+  Report state;
 };
 
-DS4Device::DS4Device() : p(new Impl()) {
-  if (p) {
-    std::cout << "Attached ViGEm DS4 pad." << std::endl;
-    return;
-  }
-
-  std::cerr << "---\nERROR\n---\nFailed to initialize ViGEm DS4 pad."
-            << std::endl;
-  exit(1);
+DS4Device::DS4Device(const std::shared_ptr<Backend>& backend)
+  : p(new Impl {backend, {}}) {
 }
 
 DS4Device::~DS4Device() {
 }
 
 void DS4Device::flush() {
-  auto& client = ViGEmClient::get();
-  if (!client) {
-    return;
-  }
-  vigem_target_ds4_update(client, p->pad, p->state);
+  p->backend->write(p->state);
 }
 
 DS4Device* DS4Device::setButton(Button button, bool value) {
   if (value) {
-    p->state.wButtons |= static_cast<USHORT>(button);
+    p->state.wButtons |= static_cast<uint16_t>(button);
   } else {
-    p->state.wButtons &= ~static_cast<USHORT>(button);
+    p->state.wButtons &= ~static_cast<uint16_t>(button);
   }
   return this;
 }
 
 DS4Device* DS4Device::setButton(SpecialButton button, bool value) {
   if (value) {
-    p->state.bSpecial |= static_cast<BYTE>(button);
+    p->state.bSpecial |= static_cast<uint8_t>(button);
   } else {
-    p->state.bSpecial &= ~static_cast<BYTE>(button);
+    p->state.bSpecial &= ~static_cast<uint8_t>(button);
   }
   return this;
 }
 
 DS4Device* DS4Device::setDPad(DPadDirection dpad) {
-  DS4_SET_DPAD(&p->state, (DS4_DPAD_DIRECTIONS)dpad);
+  // Equivalent to ViGEm's DS4_SET_DPAD()
+  p->state.wButtons &= ~0xf;
+  p->state.wButtons |= static_cast<uint16_t>(dpad);
   return this;
 }
 
-namespace {
-inline BYTE scale_axis(long value) {
-  return (value * 255) / 65535;
-}
-}// namespace
-
 DS4Device* DS4Device::setLXAxis(long value) {
-  p->state.bThumbLX = scale_axis(value);
+  p->state.bThumbLX = to_uint8_axis(value);
   return this;
 }
 DS4Device* DS4Device::setLYAxis(long value) {
-  p->state.bThumbLY = scale_axis(value);
+  p->state.bThumbLY = to_uint8_axis(value);
   return this;
 }
 DS4Device* DS4Device::setRXAxis(long value) {
-  p->state.bThumbRX = scale_axis(value);
+  p->state.bThumbRX = to_uint8_axis(value);
   return this;
 }
 DS4Device* DS4Device::setRYAxis(long value) {
-  p->state.bThumbRY = scale_axis(value);
+  p->state.bThumbRY = to_uint8_axis(value);
   return this;
 }
 
 DS4Device* DS4Device::setLTrigger(long value) {
-  p->state.bTriggerL = scale_axis(value);
+  p->state.bTriggerL = to_uint8_axis(value);
   return this;
 }
 DS4Device* DS4Device::setRTrigger(long value) {
-  p->state.bTriggerR = scale_axis(value);
+  p->state.bTriggerR = to_uint8_axis(value);
   return this;
 }
 
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/DS4Device.h>
+#include <cpp-remapper/ViGEmClient.h>
+#include <cpp-remapper/ViGEmTarget.h>
+
+#include <iostream>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+#define CHECK_VALUE(type, ours, theirs) \
+  static_assert(static_cast<int>(DS4Device::type::ours) == theirs);
+CHECK_VALUE(Button, LEFT_THUMB, DS4_BUTTON_THUMB_LEFT)
+CHECK_VALUE(Button, RIGHT_THUMB, DS4_BUTTON_THUMB_RIGHT)
+CHECK_VALUE(Button, OPTIONS, DS4_BUTTON_OPTIONS)
+CHECK_VALUE(Button, SHARE, DS4_BUTTON_SHARE)
+CHECK_VALUE(Button, LEFT_TRIGGER, DS4_BUTTON_TRIGGER_LEFT)
+CHECK_VALUE(Button, RIGHT_TRIGGER, DS4_BUTTON_TRIGGER_RIGHT)
+CHECK_VALUE(Button, LEFT_SHOULDER, DS4_BUTTON_SHOULDER_LEFT)
+CHECK_VALUE(Button, RIGHT_SHOULDER, DS4_BUTTON_SHOULDER_RIGHT)
+CHECK_VALUE(Button, TRIANGLE, DS4_BUTTON_TRIANGLE)
+CHECK_VALUE(Button, CIRCLE, DS4_BUTTON_CIRCLE)
+CHECK_VALUE(Button, CROSS, DS4_BUTTON_CROSS)
+CHECK_VALUE(Button, SQUARE, DS4_BUTTON_SQUARE)
+CHECK_VALUE(SpecialButton, PS, DS4_SPECIAL_BUTTON_PS)
+CHECK_VALUE(SpecialButton, TOUCHPAD, DS4_SPECIAL_BUTTON_TOUCHPAD)
+CHECK_VALUE(DPadDirection, NONE, DS4_BUTTON_DPAD_NONE)
+CHECK_VALUE(DPadDirection, NORTHWEST, DS4_BUTTON_DPAD_NORTHWEST)
+CHECK_VALUE(DPadDirection, WEST, DS4_BUTTON_DPAD_WEST)
+CHECK_VALUE(DPadDirection, SOUTHWEST, DS4_BUTTON_DPAD_SOUTHWEST)
+CHECK_VALUE(DPadDirection, SOUTH, DS4_BUTTON_DPAD_SOUTH)
+CHECK_VALUE(DPadDirection, SOUTHEAST, DS4_BUTTON_DPAD_SOUTHEAST)
+CHECK_VALUE(DPadDirection, EAST, DS4_BUTTON_DPAD_EAST)
+CHECK_VALUE(DPadDirection, NORTHEAST, DS4_BUTTON_DPAD_NORTHEAST)
+CHECK_VALUE(DPadDirection, NORTH, DS4_BUTTON_DPAD_NORTH)
+#undef CHECK_VALUE
+
+class DS4DriverBackend final
+  : public DS4Device::Backend,
+    public detail::ViGEmTarget<DS4DriverBackend> {
+ public:
+  static PVIGEM_TARGET allocTarget() {
+    return vigem_target_ds4_alloc();
+  }
+
+  static const char* productShortName() {
+    return "DS4 pad";
+  }
+
+  virtual void write(const DS4Device::Report& report) override {
+    auto& client = ViGEmClient::get();
+    if (!client) {
+      return;
+    }
+    const DS4_REPORT native {
+      .bThumbLX = report.bThumbLX,
+      .bThumbLY = report.bThumbLY,
+      .bThumbRX = report.bThumbRX,
+      .bThumbRY = report.bThumbRY,
+      .wButtons = report.wButtons,
+      .bSpecial = report.bSpecial,
+      .bTriggerL = report.bTriggerL,
+      .bTriggerR = report.bTriggerR,
+    };
+    vigem_target_ds4_update(client, pad, native);
+  }
+};
+}// namespace
+
+std::shared_ptr<DS4Device::Backend> DS4Device::createDriverBackend() {
+  return std::make_shared<DS4DriverBackend>();
+}
+
+DS4Device::DS4Device() : DS4Device(createDriverBackend()) {
+  std::cout << "Attached ViGEm DS4 pad." << std::endl;
+}
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/DeviceCapabilityCache.h>
+
+#include <algorithm>
+#include <concepts>
+#include <fstream>
+#include <istream>
+#include <ostream>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+// File layout, all integers little-endian:
+//   "CRDC" u32 version u32 count
+//   count * {
+//     u16 len, hardware ID
+//     u64 fingerprint u32 buttons u32 hats u8 axes
+//     axes * { u8 type, u16 len, name }
+//   }
+constexpr char MAGIC[4] = {'C', 'R', 'D', 'C'};
+constexpr uint32_t VERSION = 1;
+constexpr uint64_t FNV_PRIME = 0x100000001b3;
+// Anything past this is corrupt; AxisType is an 8-bit field in the file
+constexpr uint8_t MAX_AXIS_TYPE = static_cast<uint8_t>(AxisType::SLIDER);
+
+template <std::unsigned_integral T>
+void write(std::ostream& out, T value) {
+  char bytes[sizeof(T)];
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+  out.write(bytes, sizeof(T));
+}
+
+void write(std::ostream& out, const std::string& value) {
+  write<uint16_t>(out, static_cast<uint16_t>(value.size()));
+  out.write(value.data(), value.size());
+}
+
+template <std::unsigned_integral T>
+bool read(std::istream& in, T& value) {
+  unsigned char bytes[sizeof(T)];
+  if (!in.read(reinterpret_cast<char*>(bytes), sizeof(T))) {
+    return false;
+  }
+  value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<T>(bytes[i]) << (8 * i);
+  }
+  return true;
+}
+
+bool read(std::istream& in, std::string& value) {
+  uint16_t size;
+  if (!read(in, size)) {
+    return false;
+  }
+  value.resize(size);
+  return static_cast<bool>(in.read(value.data(), size));
+}
+
+bool read(std::istream& in, DeviceCapabilities& caps) {
+  uint8_t axisCount;
+  if (!(read(in, caps.buttons) && read(in, caps.hats) && read(in, axisCount))) {
+    return false;
+  }
+  caps.axes.reserve(axisCount);
+  for (uint8_t i = 0; i < axisCount; ++i) {
+    uint8_t type;
+    std::string name;
+    if (!(read(in, type) && read(in, name)) || type > MAX_AXIS_TYPE) {
+      return false;
+    }
+    caps.axes.push_back({static_cast<AxisType>(type), name});
+  }
+  return true;
+}
+}// namespace
+
+bool DeviceCapabilities::operator==(const DeviceCapabilities& other) const {
+  if (
+    buttons != other.buttons || hats != other.hats
+    || axes.size() != other.axes.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < axes.size(); ++i) {
+    if (
+      axes[i].type != other.axes[i].type
+      || axes[i].name != other.axes[i].name) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DeviceCapabilityCache::DeviceCapabilityCache() {
+}
+
+DeviceCapabilityCache::~DeviceCapabilityCache() {
+}
+
+DeviceCapabilityCache DeviceCapabilityCache::load(std::istream& in) {
+  char magic[sizeof(MAGIC)];
+  uint32_t version, count;
+  if (
+    !in.read(magic, sizeof(magic))
+    || !std::equal(std::begin(magic), std::end(magic), std::begin(MAGIC))
+    || !read(in, version) || version != VERSION || !read(in, count)) {
+    return {};
+  }
+
+  DeviceCapabilityCache ret;
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string hardwareID;
+    Entry entry;
+    if (!(read(in, hardwareID) && read(in, entry.fingerprint)
+          && read(in, entry.capabilities))) {
+      return {};
+    }
+    ret.mEntries.insert_or_assign(std::move(hardwareID), std::move(entry));
+  }
+  return ret;
+}
+
+DeviceCapabilityCache DeviceCapabilityCache::load(
+  const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return {};
+  }
+  return load(file);
+}
+
+void DeviceCapabilityCache::save(std::ostream& out) const {
+  out.write(MAGIC, sizeof(MAGIC));
+  write(out, VERSION);
+  write<uint32_t>(out, static_cast<uint32_t>(mEntries.size()));
+  for (const auto& [hardwareID, entry]: mEntries) {
+    const auto& caps = entry.capabilities;
+    write(out, hardwareID);
+    write(out, entry.fingerprint);
+    write(out, caps.buttons);
+    write(out, caps.hats);
+    write<uint8_t>(out, static_cast<uint8_t>(caps.axes.size()));
+    for (const auto& axis: caps.axes) {
+      write<uint8_t>(out, static_cast<uint8_t>(axis.type));
+      write(out, axis.name);
+    }
+  }
+}
+
+void DeviceCapabilityCache::save(const std::filesystem::path& path) const {
+  if (path.empty()) {
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  // Write then rename, so that a crash can't leave a truncated file behind
+  auto temporary = path;
+  temporary += ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return;
+    }
+    save(file);
+    if (!file) {
+      return;
+    }
+  }
+  std::filesystem::rename(temporary, path, ec);
+}
+
+std::optional<DeviceCapabilities> DeviceCapabilityCache::get(
+  const std::string& hardwareID,
+  uint64_t fingerprint) const {
+  auto it = mEntries.find(hardwareID);
+  if (it == mEntries.end() || it->second.fingerprint != fingerprint) {
+    return {};
+  }
+  return it->second.capabilities;
+}
+
+void DeviceCapabilityCache::set(
+  const std::string& hardwareID,
+  uint64_t fingerprint,
+  const DeviceCapabilities& caps) {
+  mEntries.insert_or_assign(hardwareID, Entry {fingerprint, caps});
+}
+
+size_t DeviceCapabilityCache::size() const {
+  return mEntries.size();
+}
+
+uint64_t DeviceCapabilityCache::fingerprint(
+  std::string_view data,
+  uint64_t seed) {
+  auto hash = seed;
+  for (const auto c: data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+}// namespace fredemmott::inputmapping
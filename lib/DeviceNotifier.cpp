@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/DeviceNotifier.h>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+// Long enough for DirectInput to have caught up with the arrival
+const std::chrono::milliseconds SETTLE_TIME(50);
+}// namespace
+
+DeviceNotifier::DeviceNotifier() : mState(std::make_shared<State>()) {
+}
+
+DeviceNotifier::~DeviceNotifier() {
+  mState->callback = {};
+}
+
+void DeviceNotifier::setCallback(const Callback& callback) {
+  mState->callback = callback;
+}
+
+void DeviceNotifier::notify() {
+  if (mState->pending) {
+    return;
+  }
+  mState->pending = true;
+  Clock::get()->setTimer(SETTLE_TIME, [state = mState]() {
+    state->pending = false;
+    if (state->callback) {
+      state->callback();
+    }
+  });
+}
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/DispatchContext.h>
+
+#include <vector>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+DispatchContext::time_point gSampleTime {};
+int gDepth = 0;
+uint64_t gDispatchID = 0;
+uint64_t gDispatchCount = 0;
+std::vector<std::function<void()>> gDeferred;
+}// namespace
+
+DispatchContext::time_point DispatchContext::getSampleTime() noexcept {
+  return gSampleTime;
+}
+
+bool DispatchContext::isDispatching() noexcept {
+  return gDepth > 0;
+}
+
+uint64_t DispatchContext::getDispatchID() noexcept {
+  return gDispatchID;
+}
+
+void DispatchContext::defer(std::function<void()> callback) {
+  if (!isDispatching()) {
+    callback();
+    return;
+  }
+  gDeferred.push_back(std::move(callback));
+}
+
+void DispatchContext::runDeferred() {
+  // Callbacks can defer more work, e.g. when chained
+  for (size_t i = 0; i < gDeferred.size(); ++i) {
+    auto callback = std::move(gDeferred[i]);
+    callback();
+  }
+  gDeferred.clear();
+}
+
+DispatchContext::Scope::Scope(time_point sampleTime) noexcept
+  : mPrevious(gSampleTime) {
+  gSampleTime = sampleTime;
+  if (gDepth++ == 0) {
+    gDispatchID = ++gDispatchCount;
+  }
+}
+
+DispatchContext::Scope::~Scope() noexcept {
+  // Usually already done by the event loop
+  if (gDepth == 1) {
+    runDeferred();
+  }
+  if (--gDepth == 0) {
+    gDispatchID = 0;
+  }
+  gSampleTime = mPrevious;
+}
+
+DispatchContext::DeferredUpdate::DeferredUpdate(std::function<void()> update)
+  : mUpdate(std::move(update)) {
+}
+
+void DispatchContext::DeferredUpdate::request() {
+  if (!isDispatching()) {
+    mUpdate();
+    return;
+  }
+  if (mPending) {
+    return;
+  }
+  mPending = true;
+  defer([this]() {
+    mPending = false;
+    mUpdate();
+  });
+}
+
+}// namespace fredemmott::inputmapping
@@ -5,11 +5,15 @@
  * This source code is licensed under the ISC license found in the LICENSE file
  * in the root directory of this source tree.
  */
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/DispatchContext.h>
 #include <cpp-remapper/EventLoop.h>
 #include <cpp-remapper/EventSink.h>
 #include <cpp-remapper/EventSource.h>
 #include <cpp-remapper/InputDevice.h>
 
+#include <algorithm>
+
 namespace fredemmott::inputmapping {
 
 namespace {
@@ -37,12 +41,23 @@ void EventLoop::setEventSinks(
   mEventSinks = sinks;
 }
 
+void EventLoop::replaceEventSink(
+  const std::shared_ptr<EventSink>& original,
+  const std::shared_ptr<EventSink>& replacement) {
+  std::ranges::replace(mEventSinks, original, replacement);
+}
+
 void EventLoop::setEventSources(
   const std::vector<std::shared_ptr<EventSource>>& sources) {
   mEventSources = sources;
 }
 
+void EventLoop::addEventSource(const std::shared_ptr<EventSource>& source) {
+  mEventSources.push_back(source);
+}
+
 void EventLoop::run() {
+  Clock::setTimerTarget(&EventLoop::inject);
   if (mEventSources.empty()) {
     printf(
       "---\n"
@@ -64,23 +79,23 @@ void EventLoop::run() {
   // we want to reset the HidHide configuration.
   gExitEvent = CreateEvent(nullptr, false, false, nullptr);
   SetConsoleCtrlHandler(&exit_event_handler, true);
-  std::vector<HANDLE> fixed_events {gExitEvent};
-
-  std::map<HANDLE, std::shared_ptr<EventSource>> handle_to_source;
-  for (const auto& source: mEventSources) {
-    auto handle = source->getHandle();
-    fixed_events.push_back(handle);
-    handle_to_source.insert({handle, source});
-  }
   printf("---\nProfile running, hit Ctrl-C to exit and clean up HidHide.\n");
+  std::vector<HANDLE> events;
   while (true) {
-    auto events = fixed_events;
+    // Handles are fetched each time as sources can change device, e.g.
+    // when one is reconnected
+    events.clear();
+    events.push_back(gExitEvent);
+    for (const auto& source: mEventSources) {
+      events.push_back(source->getHandle());
+    }
     for (const auto& [event, _]: mInjected) {
       events.push_back(event);
     }
     const auto res
       = WaitForMultipleObjects(events.size(), events.data(), false, INFINITE);
-    auto event = events[res - WAIT_OBJECT_0];
+    const auto index = res - WAIT_OBJECT_0;
+    auto event = events[index];
     if (event == gExitEvent) {
       SetConsoleCtrlHandler(nullptr, false);
       CloseHandle(gExitEvent);
@@ -92,17 +107,24 @@ void EventLoop::run() {
 
     auto injected = mInjected.find(event);
     if (injected != mInjected.end()) {
-      injected->second();
+      // Timers are treated as sampled when they were due, not when they
+      // were handled
+      DispatchContext::Scope dispatch(injected->second.deadline);
+      injected->second.handler();
       mInjected.erase(event);
       CloseHandle(event);
+      DispatchContext::runDeferred();
       flush();
       continue;
     }
 
-    auto source = handle_to_source.at(event);
+    // Kept until after flush() so that outputs can see how old the input is
+    DispatchContext::Scope dispatch(std::chrono::steady_clock::now());
+    auto source = mEventSources.at(index - 1);
     source->poll();
-    gActiveInstance = nullptr;
-
+    DispatchContext::runDeferred();
+    // Still active, as sinks can set timers while flushing; for example,
+    // `RateLimitedSink` schedules trailing flushes
     flush();
   }
 }
@@ -133,9 +155,7 @@ void EventLoop::inject(
   auto timer = CreateWaitableTimer(nullptr, true, nullptr);
   SetWaitableTimer(
     timer, (LARGE_INTEGER*)&target_time, 0, nullptr, nullptr, false);
-  gActiveInstance->mInjected.emplace(timer, [handler, timer]() {
-    CloseHandle(timer);
-    handler();
-  });
+  gActiveInstance->mInjected.emplace(
+    timer, Injected {std::chrono::steady_clock::now() + delay, handler});
 }
 }// namespace fredemmott::inputmapping
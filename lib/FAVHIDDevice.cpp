@@ -7,12 +7,18 @@
  */
 #include <cpp-remapper/FAVHIDDevice.h>
 
+#include <array>
+#include <bitset>
 #include <format>
 #include <iostream>
+#include <mutex>
 
 namespace fredemmott::inputmapping {
 
 namespace {
+// All FAVHIDDevices share one Arduino; they may be written to from different
+// threads, e.g. each with its own AsyncOutputBackend
+std::mutex gMutex;
 uint8_t gDeviceCount {};
 std::optional<FAVHID::FAVJoyState2> gArduino;
 
@@ -27,44 +33,134 @@ void InitializeFAVHID() {
   }
 }
 
+class FAVHIDDriverBackend final : public FAVHIDDevice::Backend {
+ public:
+  FAVHIDDriverBackend(uint8_t id) : mID(id) {
+    std::scoped_lock lock(gMutex);
+    gDeviceCount = std::max<uint8_t>(gDeviceCount, id + 1);
+  }
+
+  virtual void write(const FAVHID::FAVJoyState2::Report& report) override {
+    std::scoped_lock lock(gMutex);
+    InitializeFAVHID();
+    if (!gArduino) {
+      return;
+    }
+    gArduino->WriteReport(report, mID);
+  }
+
+ private:
+  uint8_t mID {};
+};
+
 }// namespace
 
 struct FAVHIDDevice::Impl final {
-  uint8_t mID {};
-  FAVHID::FAVJoyState2::Report mReport;
+  // nullptr if the device ID is invalid
+  std::shared_ptr<Backend> mBackend;
+  Report mReport {};
+  // Start dirty so that the first `flush()` sends the initial state
+  uint16_t mChangedFields {ALL_FIELDS};
+  // `Report` is write-only; these let us skip no-op updates. -1 for a hat
+  // or an unset bit in `mKnownButtons` means we don't know the value.
+  std::bitset<128> mButtons;
+  std::bitset<128> mKnownButtons {std::bitset<128>().set()};
+  std::array<int8_t, 4> mHats {};
+
+  template <class T>
+  void update(T& field, T value, ChangedField bit) {
+    if (field == value) {
+      return;
+    }
+    field = value;
+    mChangedFields |= bit;
+  }
 };
 
-FAVHIDDevice::FAVHIDDevice(uint8_t id) {
+std::shared_ptr<FAVHIDDevice::Backend> FAVHIDDevice::createDriverBackend(
+  uint8_t id) {
   if (id >= FAVHID::FAVJoyState2::MAX_DEVICES) {
     std::cerr << std::format(
       "Ignoring FAVHIDDevice because requested ID {} >= MAX_DEVICES {}",
       id,
       FAVHID::FAVJoyState2::MAX_DEVICES)
               << std::endl;
-    return;
+    return nullptr;
   }
+  return std::make_shared<FAVHIDDriverBackend>(id);
+}
 
-  p.reset(new Impl {.mID = id, .mReport = {}});
-  gDeviceCount = std::max<uint8_t>(gDeviceCount, id + 1);
+FAVHIDDevice::FAVHIDDevice(uint8_t id)
+  : FAVHIDDevice(createDriverBackend(id)) {
 }
+
+FAVHIDDevice::FAVHIDDevice(const std::shared_ptr<Backend>& backend)
+  : p(new Impl {.mBackend = backend}) {
+}
+
 FAVHIDDevice::~FAVHIDDevice() = default;
 
-void FAVHIDDevice::set(const FAVHID::FAVJoyState2::Report& report) {
-  if (!p) {
-    return;
-  }
+void FAVHIDDevice::set(const Report& report) {
   p->mReport = report;
+  p->mChangedFields = ALL_FIELDS;
+  p->mKnownButtons.reset();
+  p->mHats.fill(-1);
 }
 
-void FAVHIDDevice::flush() {
-  if (!p) {
-    return;
+#define AXIS_SETTER(name, member, bit) \
+  FAVHIDDevice* FAVHIDDevice::set##name(int16_t value) { \
+    p->update<int16_t>(p->mReport.member, value, bit); \
+    return this; \
   }
-  InitializeFAVHID();
-  if (!gArduino) {
+AXIS_SETTER(XAxis, x, X_AXIS)
+AXIS_SETTER(YAxis, y, Y_AXIS)
+AXIS_SETTER(ZAxis, z, Z_AXIS)
+AXIS_SETTER(RXAxis, rx, RX_AXIS)
+AXIS_SETTER(RYAxis, ry, RY_AXIS)
+AXIS_SETTER(RZAxis, rz, RZ_AXIS)
+AXIS_SETTER(Slider, slider[0], SLIDER)
+AXIS_SETTER(Dial, slider[1], DIAL)
+#undef AXIS_SETTER
+
+FAVHIDDevice* FAVHIDDevice::setButton(uint8_t button, bool value) {
+  if (button < 1 || button > p->mButtons.size()) {
+    return this;
+  }
+  const auto index = button - 1;
+  if (p->mKnownButtons.test(index) && p->mButtons.test(index) == value) {
+    return this;
+  }
+  p->mButtons.set(index, value);
+  p->mKnownButtons.set(index);
+  p->mReport.SetButton(index, value);
+  p->mChangedFields |= BUTTONS;
+  return this;
+}
+
+FAVHIDDevice* FAVHIDDevice::setHat(uint8_t hat, int8_t value) {
+  if (hat < 1 || hat > p->mHats.size()) {
+    return this;
+  }
+  const auto index = hat - 1;
+  if (p->mHats[index] == value) {
+    return this;
+  }
+  p->mHats[index] = value;
+  p->mReport.SetPOV(index, value);
+  p->mChangedFields |= HATS;
+  return this;
+}
+
+uint16_t FAVHIDDevice::getChangedFields() const {
+  return p->mChangedFields;
+}
+
+void FAVHIDDevice::flush() {
+  if (!(p->mBackend && p->mChangedFields)) {
     return;
   }
-  gArduino->WriteReport(p->mReport, p->mID);
+  p->mBackend->write(p->mReport);
+  p->mChangedFields = 0;
 }
 
 }// namespace fredemmott::inputmapping
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/HIDDeviceNotifier.h>
+
+// clang-format off
+#include <initguid.h>
+#include <hidclass.h>
+// clang-format on
+
+#include <cfgmgr32.h>
+
+#pragma comment(lib, "Cfgmgr32.lib")
+
+namespace fredemmott::inputmapping {
+
+namespace {
+DWORD CALLBACK on_notification(
+  HCMNOTIFICATION,
+  PVOID context,
+  CM_NOTIFY_ACTION action,
+  PCM_NOTIFY_EVENT_DATA,
+  DWORD) {
+  if (
+    action == CM_NOTIFY_ACTION_DEVICEINTERFACEARRIVAL
+    || action == CM_NOTIFY_ACTION_DEVICEINTERFACEREMOVAL) {
+    // Called on a thread pool thread; let the EventLoop do the real work
+    SetEvent(reinterpret_cast<HANDLE>(context));
+  }
+  return ERROR_SUCCESS;
+}
+}// namespace
+
+struct HIDDeviceNotifier::Impl {
+  HANDLE event = nullptr;
+  HCMNOTIFICATION notification = nullptr;
+};
+
+HIDDeviceNotifier::HIDDeviceNotifier() : p(std::make_unique<Impl>()) {
+  p->event = CreateEvent(nullptr, false, false, nullptr);
+
+  CM_NOTIFY_FILTER filter {
+    .cbSize = sizeof(CM_NOTIFY_FILTER),
+    .FilterType = CM_NOTIFY_FILTER_TYPE_DEVICEINTERFACE,
+  };
+  filter.u.DeviceInterface.ClassGuid = GUID_DEVINTERFACE_HID;
+  if (
+    CM_Register_Notification(
+      &filter, p->event, &on_notification, &p->notification)
+    != CR_SUCCESS) {
+    printf(
+      "WARNING: Failed to register for device notifications; devices that "
+      "are unplugged will not be reconnected.\n");
+    p->notification = nullptr;
+  }
+}
+
+HIDDeviceNotifier::~HIDDeviceNotifier() {
+  if (p->notification) {
+    // Waits for any in-progress callbacks
+    CM_Unregister_Notification(p->notification);
+  }
+  CloseHandle(p->event);
+}
+
+HANDLE HIDDeviceNotifier::getHandle() {
+  return p->event;
+}
+
+void HIDDeviceNotifier::poll() {
+  notify();
+}
+
+}// namespace fredemmott::inputmapping
@@ -34,10 +34,12 @@ constexpr unsigned int IoControlDeviceType {32769};
 }// namespace
 
 namespace fredemmott::inputmapping {
-HidHide::HidHide(const std::vector<DeviceSpecifier>& specifiers) {
+HidHide::HidHide(
+  const InputDeviceCollection& collection,
+  const std::vector<DeviceSpecifier>& specifiers) {
   printf("Configuring HidHide...\n");
   try {
-    init(specifiers);
+    init(collection, specifiers);
     mInitialized = true;
   } catch (const std::runtime_error& e) {
     fprintf(
@@ -53,21 +55,41 @@ HidHide::HidHide(const std::vector<DeviceSpecifier>& specifiers) {
   }
 }
 
-void HidHide::init(const std::vector<DeviceSpecifier>& specifiers) {
-  InputDeviceCollection collection;
+void HidHide::init(
+  const InputDeviceCollection& collection,
+  const std::vector<DeviceSpecifier>& specifiers) {
   if (!getControlDevice()) {
     std::cout << "Couldn't connect to HidHide, ignoring" << std::endl;
     return;
   }
 
   ensureApplicationIsWhitelisted();
-  for (const auto& specifier: specifiers) {
+  mSpecifiers = specifiers;
+  hideDevices(collection);
+}
+
+void HidHide::update(const InputDeviceCollection& collection) {
+  if (!mInitialized) {
+    return;
+  }
+  try {
+    hideDevices(collection);
+  } catch (const std::runtime_error& e) {
+    fprintf(stderr, "WARNING: Failed to update HidHide: %s\n", e.what());
+  }
+}
+
+void HidHide::hideDevices(const InputDeviceCollection& collection) {
+  for (const auto& specifier: mSpecifiers) {
     auto device = collection.get(specifier);
     if (!device) {
       continue;
     }
-    auto instance = device->getInstanceID();
-    mEntries.push_back({instance.toWString()});
+    auto instance = device->getInstanceID().toWString();
+    if (!mHiddenInstances.insert(instance).second) {
+      continue;
+    }
+    mEntries.push_back({instance});
   }
 }
 
@@ -15,9 +15,12 @@
 
 #include <Cfgmgr32.h>
 #include <cpp-remapper/AxisInformation.h>
+#include <cpp-remapper/DeviceCapabilityCache.h>
 #include <setupapi.h>
 #include <winrt/base.h>
 
+#include <stdexcept>
+
 #pragma comment(lib, "dinput8.lib")
 #pragma comment(lib, "dxguid.lib")
 #pragma comment(lib, "Cfgmgr32.lib")
@@ -26,15 +29,9 @@
 namespace fredemmott::inputmapping {
 
 namespace {
-struct ControlInfo {
-  uint32_t buttons = 0;
-  uint32_t hats = 0;
-  std::vector<AxisInformation> axes {};
-};
-
 static BOOL CALLBACK
 enum_controls_callback(LPCDIDEVICEOBJECTINSTANCEA obj, LPVOID pvRef) {
-  auto data = reinterpret_cast<ControlInfo*>(pvRef);
+  auto data = reinterpret_cast<DeviceCapabilities*>(pvRef);
   if (obj->guidType == GUID_POV) {
     data->hats++;
     return DIENUM_CONTINUE;
@@ -77,15 +74,29 @@ enum_controls_callback(LPCDIDEVICEOBJECTINSTANCEA obj, LPVOID pvRef) {
 
   return DIENUM_CONTINUE;
 }
+
+DeviceCapabilities enumerate_controls(LPDIRECTINPUTDEVICE8A device) {
+  DeviceCapabilities ret;
+  device->EnumObjects(
+    &enum_controls_callback, &ret, DIDFT_AXIS | DIDFT_BUTTON | DIDFT_POV);
+  return ret;
+}
 }// namespace
 
 struct InputDevice::Impl {
-  ControlInfo controlsData;
+  DeviceCapabilities controlsData;
   IDirectInput8A* di8 = nullptr;
   DIDEVICEINSTANCEA device;
   LPDIRECTINPUTDEVICE8A diDevice = nullptr;
   bool enumerated = false;
 
+  // Identity doesn't change while the device is attached, and querying it
+  // involves several DirectInput and CfgMgr calls, so fetch it once.
+  std::optional<VIDPID> vidpid;
+  std::string instanceID;
+  std::string hardwareID;
+  uint64_t fingerprint = 0;
+
   void operator=(const Impl& other) = delete;
 
   ~Impl() {
@@ -100,26 +111,69 @@ struct InputDevice::Impl {
     return diDevice;
   }
 
-  const ControlInfo& controls() {
+  const DeviceCapabilities& controls() {
     if (enumerated) {
       return controlsData;
     }
     getDIDevice()->Acquire();
-    getDIDevice()->EnumObjects(
-      &enum_controls_callback,
-      &controlsData,
-      DIDFT_AXIS | DIDFT_BUTTON | DIDFT_POV);
+    controlsData = enumerate_controls(getDIDevice());
     enumerated = true;
     return controlsData;
   }
-};
-struct Foo {
-  std::string bar;
-  Foo(const Foo&) = delete;
+
+  void fetchIdentity() {
+    // Cheap properties that change if the HID descriptor does; used to
+    // check that cached capabilities are still valid.
+    DIDEVCAPS caps {.dwSize = sizeof(DIDEVCAPS)};
+    getDIDevice()->GetCapabilities(&caps);
+    const uint32_t summary[] = {
+      device.dwDevType, caps.dwAxes, caps.dwButtons, caps.dwPOVs};
+    fingerprint = DeviceCapabilityCache::fingerprint(
+      {reinterpret_cast<const char*>(&device.guidProduct),
+       sizeof(device.guidProduct)});
+    fingerprint = DeviceCapabilityCache::fingerprint(
+      {reinterpret_cast<const char*>(summary), sizeof(summary)}, fingerprint);
+    fingerprint
+      = DeviceCapabilityCache::fingerprint(device.tszProductName, fingerprint);
+
+    DIPROPDWORD vidpidBuf;
+    vidpidBuf.diph.dwSize = sizeof(DIPROPDWORD);
+    vidpidBuf.diph.dwHeaderSize = sizeof(DIPROPHEADER);
+    vidpidBuf.diph.dwObj = 0;
+    vidpidBuf.diph.dwHow = DIPH_DEVICE;
+    if (
+      getDIDevice()->GetProperty(DIPROP_VIDPID, &vidpidBuf.diph) == DI_OK) {
+      vidpid = VIDPID {LOWORD(vidpidBuf.dwData), HIWORD(vidpidBuf.dwData)};
+    }
+
+    DIPROPGUIDANDPATH buf;
+    buf.diph.dwSize = sizeof(DIPROPGUIDANDPATH);
+    buf.diph.dwHeaderSize = sizeof(DIPROPHEADER);
+    buf.diph.dwObj = 0;
+    buf.diph.dwHow = DIPH_DEVICE;
+    getDIDevice()->GetProperty(DIPROP_GUIDANDPATH, &buf.diph);
+    ULONG id_size = 0;
+    DEVPROPTYPE type;
+    CM_Get_Device_Interface_PropertyW(
+      buf.wszPath, &DEVPKEY_Device_InstanceId, &type, nullptr, &id_size, 0);
+    if (id_size < sizeof(wchar_t)) {
+      return;
+    }
+    std::vector<BYTE> id(id_size);
+    CM_Get_Device_Interface_PropertyW(
+      buf.wszPath, &DEVPKEY_Device_InstanceId, &type, id.data(), &id_size, 0);
+
+    std::wstring_view view {
+      reinterpret_cast<wchar_t*>(id.data()), (id_size / sizeof(wchar_t)) - 1};
+    instanceID = winrt::to_string(view);
+    // Split off the \instanceID suffix
+    hardwareID = instanceID.substr(0, instanceID.rfind('\\'));
+  }
 };
 
 InputDevice::InputDevice(IDirectInput8A* di, LPCDIDEVICEINSTANCEA device)
   : p(new Impl {.di8 = di, .device = *device}) {
+  p->fetchIdentity();
 }
 
 InputDevice::~InputDevice() {
@@ -130,6 +184,22 @@ InputDevice::~InputDevice() {
   }
 }
 
+const GUID& InputDevice::getInstanceGUID() const {
+  return p->device.guidInstance;
+}
+
+bool InputDevice::reacquire() {
+  auto device = p->getDIDevice();
+  if (!mActivated) {
+    // Can't be acquired until it has a data format
+    DIDEVCAPS caps {.dwSize = sizeof(DIDEVCAPS)};
+    return device->GetCapabilities(&caps) == DI_OK
+      && (caps.dwFlags & DIDC_ATTACHED);
+  }
+  device->Unacquire();
+  return SUCCEEDED(device->Acquire());
+}
+
 std::string InputDevice::getInstanceName() const {
   return p->device.tszInstanceName;
 }
@@ -139,52 +209,53 @@ std::string InputDevice::getProductName() const {
 }
 
 InstanceID InputDevice::getInstanceID() const {
-  DIPROPGUIDANDPATH buf;
-  buf.diph.dwSize = sizeof(DIPROPGUIDANDPATH);
-  buf.diph.dwHeaderSize = sizeof(DIPROPHEADER);
-  buf.diph.dwObj = 0;
-  buf.diph.dwHow = DIPH_DEVICE;
-  p->getDIDevice()->GetProperty(DIPROP_GUIDANDPATH, &buf.diph);
-  ULONG id_size = 0;
-  DEVPROPTYPE type;
-  CM_Get_Device_Interface_PropertyW(
-    buf.wszPath, &DEVPKEY_Device_InstanceId, &type, nullptr, &id_size, 0);
-  std::vector<BYTE> id(id_size);
-  CM_Get_Device_Interface_PropertyW(
-    buf.wszPath, &DEVPKEY_Device_InstanceId, &type, id.data(), &id_size, 0);
-
-  std::wstring_view view {
-    reinterpret_cast<wchar_t*>(id.data()), (id_size / sizeof(wchar_t)) - 1};
-  auto utf8 = winrt::to_string(view);
-  return utf8;
+  return {p->instanceID};
 }
 
 HardwareID InputDevice::getHardwareID() const {
-  auto id = getInstanceID().toString();
-  // Totaly legit way to split off the \instanceID suffix
-  *strrchr(id.data(), '\\') = 0;
-
-  return {id.data()};
+  return {p->hardwareID};
 }
 
 std::optional<VIDPID> InputDevice::getVIDPID() const {
-  DIPROPDWORD buf;
-  buf.diph.dwSize = sizeof(DIPROPDWORD);
-  buf.diph.dwHeaderSize = sizeof(DIPROPHEADER);
-  buf.diph.dwObj = 0;
-  buf.diph.dwHow = DIPH_DEVICE;
-  if (p->getDIDevice()->GetProperty(DIPROP_VIDPID, &buf.diph) == DI_OK) {
-    return {{LOWORD(buf.dwData), HIWORD(buf.dwData)}};
+  return p->vidpid;
+}
+
+uint64_t InputDevice::getCapabilityFingerprint() const {
+  return p->fingerprint;
+}
+
+const DeviceCapabilities& InputDevice::getCapabilities() {
+  return p->controls();
+}
+
+void InputDevice::setCapabilities(const DeviceCapabilities& caps) {
+  if (mActivated) {
+    throw std::logic_error(
+      "Can't change the capabilities of a device that's in use");
   }
+  p->controlsData = caps;
+  p->enumerated = true;
+}
 
-  return {};
+std::optional<DeviceCapabilities> InputDevice::probeCapabilities() const {
+  // Use a separate DirectInput device so this is safe to call from another
+  // thread while this one is in use
+  LPDIRECTINPUTDEVICE8A device = nullptr;
+  if (
+    p->di8->CreateDevice(p->device.guidInstance, &device, nullptr) != DI_OK) {
+    // e.g. unplugged
+    return {};
+  }
+  auto ret = enumerate_controls(device);
+  device->Release();
+  return ret;
 }
 
 uint32_t InputDevice::getAxisCount() {
-  return getAxisInformation().size();
+  return p->controls().axes.size();
 }
 
-std::vector<AxisInformation> InputDevice::getAxisInformation() {
+const std::vector<AxisInformation>& InputDevice::getAxisInformation() {
   return p->controls().axes;
 }
 
@@ -260,6 +331,7 @@ void InputDevice::activate() {
   };
   p->diDevice->SetDataFormat(&data);
   mOffsets = {firstAxis, firstButton, firstHat};
+  mLastState.resize(mDataSize);
   auto name = this->getProductName();
   delete[] df;
 
@@ -284,7 +356,19 @@ InputDevice::State InputDevice::getState() {
   activate();
   p->diDevice->Poll();
   std::vector<std::byte> buf(mDataSize);
-  p->diDevice->GetDeviceState(mDataSize, buf.data());
+  auto result = p->diDevice->GetDeviceState(mDataSize, buf.data());
+  if (result == DIERR_INPUTLOST || result == DIERR_NOTACQUIRED) {
+    // Not necessarily unplugged - e.g. after resume - so try again
+    if (SUCCEEDED(p->diDevice->Acquire())) {
+      p->diDevice->Poll();
+      result = p->diDevice->GetDeviceState(mDataSize, buf.data());
+    }
+  }
+  if (result != DI_OK) {
+    // Most likely unplugged; report the last known state rather than zeroes
+    return State(mOffsets, mLastState);
+  }
+  mLastState = buf;
   return State(mOffsets, buf);
 }
 
@@ -7,31 +7,75 @@
  */
 #include <cpp-remapper/InputDeviceCollection.h>
 
+#include <ShlObj.h>
 #include <cpp-remapper/AxisInformation.h>
+#include <cpp-remapper/DeviceCapabilityCache.h>
 #include <cpp-remapper/InputDevice.h>
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstdio>
+#include <filesystem>
+#include <tuple>
+#include <type_traits>
 #pragma comment(lib, "Ole32.lib")// GUID
+#pragma comment(lib, "Shell32.lib")// SHGetKnownFolderPath
 
 namespace fredemmott::inputmapping {
 
 namespace {
-struct DeviceEnumeratorState {
-  IDirectInput8* di8;
-  std::vector<std::shared_ptr<InputDevice>> devices;
-};
-
 BOOL CALLBACK
 enum_device_callback(LPCDIDEVICEINSTANCE didevinst, LPVOID vpRef) {
-  auto state = reinterpret_cast<DeviceEnumeratorState*>(vpRef);
-  auto device = std::make_shared<InputDevice>(state->di8, didevinst);
-  state->devices.push_back(device);
+  auto instances = reinterpret_cast<std::vector<DIDEVICEINSTANCE>*>(vpRef);
+  instances->push_back(*didevinst);
 
   return DIENUM_CONTINUE;
 }
 
 IDirectInput8* gDI8 = nullptr;
+
+uint32_t vidpid_key(const VIDPID& vidpid) {
+  const auto [vid, pid] = static_cast<std::tuple<uint16_t, uint16_t>>(vidpid);
+  return (static_cast<uint32_t>(vid) << 16) | pid;
+}
+
+std::filesystem::path get_capability_cache_path() {
+  PWSTR folder = nullptr;
+  if (
+    SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &folder) != S_OK) {
+    CoTaskMemFree(folder);
+    return {};
+  }
+  std::filesystem::path ret(folder);
+  CoTaskMemFree(folder);
+  return ret / "cpp-remapper" / "device-capabilities.bin";
+}
+
+template <typename TKey>
+std::shared_ptr<InputDevice> find_device(
+  const std::unordered_map<TKey, std::shared_ptr<InputDevice>>& index,
+  const TKey& key) {
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+std::vector<DIDEVICEINSTANCE> enumerate_instances() {
+  std::vector<DIDEVICEINSTANCE> instances;
+  gDI8->EnumDevices(
+    DI8DEVCLASS_GAMECTRL,
+    &enum_device_callback,
+    &instances,
+    DIEDFL_ATTACHEDONLY);
+  return instances;
+}
 }// namespace
 
-InputDeviceCollection::InputDeviceCollection() {
+InputDeviceCollection::InputDeviceCollection()
+  : mCachePath(get_capability_cache_path()),
+    mCache(DeviceCapabilityCache::load(mCachePath)) {
   if (!gDI8) {
     DirectInput8Create(
       GetModuleHandle(nullptr),
@@ -40,25 +84,189 @@ InputDeviceCollection::InputDeviceCollection() {
       (LPVOID*)&gDI8,
       nullptr);
   }
+  const auto start = std::chrono::steady_clock::now();
+
+  const auto probed = probe(enumerate_instances());
+  mDevices = probed.devices;
+  updateIndexes();
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start);
+  printf(
+    "Found %zu input devices in %lldms (%zu cached)\n",
+    mDevices.size(),
+    static_cast<long long>(elapsed.count()),
+    probed.cached);
+}
+
+InputDeviceCollection::Changes InputDeviceCollection::rescan() {
+  const auto start = std::chrono::steady_clock::now();
+  const auto instances = enumerate_instances();
+
+  Changes changes;
+  std::vector<DIDEVICEINSTANCE> added;
+  // In enumeration order, like the initial scan, so that `get()` picks the
+  // same device when several match; nullptr where a device is added
+  std::vector<std::shared_ptr<InputDevice>> devices;
+  for (const auto& instance: instances) {
+    auto it = std::ranges::find_if(mDevices, [&](const auto& device) {
+      return device->getInstanceGUID() == instance.guidInstance;
+    });
+    // If a device was unplugged and plugged back in between rescans, the
+    // old DirectInput device is no longer usable even though it's still
+    // listed, so replace it too.
+    if (it != mDevices.end() && (*it)->reacquire()) {
+      devices.push_back(*it);
+      continue;
+    }
+    added.push_back(instance);
+    devices.push_back(nullptr);
+  }
+  for (const auto& device: mDevices) {
+    if (std::ranges::find(devices, device) == devices.end()) {
+      changes.removed.push_back(device);
+    }
+  }
+
+  if (added.empty() && changes.removed.empty()) {
+    return changes;
+  }
+
+  changes.added = probe(added).devices;
+  auto next = changes.added.begin();
+  for (auto& device: devices) {
+    if (!device) {
+      device = *next++;
+    }
+  }
+  mDevices = devices;
+  updateIndexes();
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start);
+  printf(
+    "Rescanned input devices in %lldms: %zu added, %zu removed\n",
+    static_cast<long long>(elapsed.count()),
+    changes.added.size(),
+    changes.removed.size());
+  return changes;
+}
+
+InputDeviceCollection::ProbeResult InputDeviceCollection::probe(
+  const std::vector<DIDEVICEINSTANCE>& instances) {
   auto di8 = gDI8;
-  DeviceEnumeratorState state {di8, {}};
-  di8->EnumDevices(
-    DI8DEVCLASS_GAMECTRL, &enum_device_callback, &state, DIEDFL_ATTACHEDONLY);
-  mDevices = state.devices;
+  std::unique_lock lock(mCacheMutex);
+
+  // Probing each device is a handful of round trips to the driver; do them
+  // all at once instead of one device after another.
+  struct Probe {
+    std::shared_ptr<InputDevice> device;
+    bool cached;
+  };
+  std::vector<std::future<Probe>> probes;
+  probes.reserve(instances.size());
+  for (const auto& instance: instances) {
+    probes.push_back(std::async(std::launch::async, [this, di8, &instance]() {
+      auto device = std::make_shared<InputDevice>(di8, &instance);
+      const auto cached = mCache.get(
+        device->getHardwareID().toString(), device->getCapabilityFingerprint());
+      if (cached) {
+        device->setCapabilities(*cached);
+        return Probe {device, true};
+      }
+      // Enumerate the controls now rather than on first use
+      device->getCapabilities();
+      return Probe {device, false};
+    }));
+  }
+
+  ProbeResult ret;
+  std::vector<std::shared_ptr<InputDevice>> unvalidated;
+  bool cacheChanged = false;
+  ret.devices.reserve(probes.size());
+  for (auto& future: probes) {
+    auto probe = future.get();
+    ret.devices.push_back(probe.device);
+    if (probe.cached) {
+      unvalidated.push_back(probe.device);
+      continue;
+    }
+    mCache.set(
+      probe.device->getHardwareID().toString(),
+      probe.device->getCapabilityFingerprint(),
+      probe.device->getCapabilities());
+    cacheChanged = true;
+  }
+  if (cacheChanged) {
+    mCache.save(mCachePath);
+  }
+  lock.unlock();
+
+  ret.cached = unvalidated.size();
+  if (unvalidated.empty()) {
+    return ret;
+  }
+
+  std::erase_if(mValidations, [](const auto& validation) {
+    return validation.wait_for(std::chrono::seconds(0))
+      == std::future_status::ready;
+  });
+  // The fingerprint should catch changes, but double-check the cache in the
+  // background; the mappings have already been set up by the time this
+  // finishes, so the best we can do is fix the cache for the next run.
+  mValidations.push_back(std::async(
+    std::launch::async, [this, devices = std::move(unvalidated)]() {
+      for (const auto& device: devices) {
+        const auto actual = device->probeCapabilities();
+        if (!actual || *actual == device->getCapabilities()) {
+          continue;
+        }
+        const auto name = device->getProductName();
+        printf(
+          "WARNING: cached capabilities for '%s' were out of date; restart to "
+          "use the new ones.\n",
+          name.c_str());
+        std::unique_lock lock(mCacheMutex);
+        mCache.set(
+          device->getHardwareID().toString(),
+          device->getCapabilityFingerprint(),
+          *actual);
+        mCache.save(mCachePath);
+      }
+    }));
+  return ret;
 }
 
-std::shared_ptr<InputDevice> InputDeviceCollection::get(
-  const DeviceSpecifier& id) {
-  for (auto device: mDevices) {
-    if (id.matches(*device)) {
-      return device;
+void InputDeviceCollection::updateIndexes() {
+  mByVIDPID.clear();
+  mByHardwareID.clear();
+  mByInstanceID.clear();
+  for (const auto& device: mDevices) {
+    if (const auto vidpid = device->getVIDPID()) {
+      mByVIDPID.try_emplace(vidpid_key(*vidpid), device);
     }
+    mByHardwareID.try_emplace(device->getHardwareID().toString(), device);
+    mByInstanceID.try_emplace(device->getInstanceID().toString(), device);
   }
-  return nullptr;
+}
+
+std::shared_ptr<InputDevice> InputDeviceCollection::get(
+  const DeviceSpecifier& id) const {
+  return id.visit([this](const auto& specifier) {
+    using T = std::decay_t<decltype(specifier)>;
+    if constexpr (std::same_as<T, VIDPID>) {
+      return find_device(mByVIDPID, vidpid_key(specifier));
+    } else if constexpr (std::same_as<T, HardwareID>) {
+      return find_device(mByHardwareID, specifier.toString());
+    } else {
+      static_assert(std::same_as<T, InstanceID>);
+      return find_device(mByInstanceID, specifier.toString());
+    }
+  });
 }
 
 std::vector<std::shared_ptr<InputDevice>>
-InputDeviceCollection::getAllDevices() {
+InputDeviceCollection::getAllDevices() const {
   return mDevices;
 }
 
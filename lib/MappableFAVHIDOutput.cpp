@@ -9,52 +9,38 @@
 #include <cpp-remapper/FAVHIDDevice.h>
 #include <cpp-remapper/InputDevice.h>
 #include <cpp-remapper/MappableFAVHIDOutput.h>
+#include <cpp-remapper/OutputConversions.h>
+
+#include <concepts>
 
 namespace fredemmott::inputmapping {
 
 struct MappableFAVHIDOutput::Impl final {
+  // The report itself lives in the device; sinks update it in place
   std::shared_ptr<FAVHIDDevice> mDevice;
-  FAVHID::FAVJoyState2::Report mState {};
 };
 
 MappableFAVHIDOutput::MappableFAVHIDOutput(uint8_t favhid_id)
   : MappableFAVHIDOutput(std::make_shared<FAVHIDDevice>(favhid_id)) {
 }
 
-static constexpr decltype(FAVHID::FAVJoyState2::Report::x) ConvertAxisValue(
-  Axis::Value input) {
-  int64_t value = input;
-  value -= Axis::MIN;
-
-  constexpr auto inputRange = Axis::MAX - Axis::MIN;
-  using outputLimits
-    = std::numeric_limits<decltype(FAVHID::FAVJoyState2::Report::x)>;
-  constexpr auto outputRange = outputLimits::max() - outputLimits::min();
-
-  value *= outputRange;
-  value /= inputRange;
-
-  value += outputLimits::min();
-
-  return value;
-}
+static_assert(
+  std::same_as<decltype(FAVHID::FAVJoyState2::Report::x), int16_t>,
+  "to_favhid_axis() needs updating");
 
 MappableFAVHIDOutput::MappableFAVHIDOutput(std::shared_ptr<FAVHIDDevice> dev)
   : p(new Impl {dev}),
-#define A(myMember, reportMember) \
-  myMember([this](long value) { \
-    p->mState.reportMember = ConvertAxisValue(value); \
-    p->mDevice->set(p->mState); \
-  })
-#define AA(myMember, reportMember) A(myMember##Axis, reportMember)
-    AA(X, x),
-    AA(Y, y),
-    AA(Z, z),
-    AA(RX, rx),
-    AA(RY, ry),
-    AA(RZ, rz),
-    A(Slider, slider[0]),
-    A(Dial, slider[1]),
+#define A(a) \
+  a([dev](long value) { dev->set##a(to_favhid_axis(value)); })
+#define AA(a) A(a##Axis)
+    AA(X),
+    AA(Y),
+    AA(Z),
+    AA(RX),
+    AA(RY),
+    AA(RZ),
+    A(Slider),
+    A(Dial),
 #undef AA
 #undef A
 #define B(n) Button##n(button(n))
@@ -208,23 +194,14 @@ std::shared_ptr<OutputDevice> MappableFAVHIDOutput::getDevice() const {
 }
 
 ButtonSinkPtr MappableFAVHIDOutput::button(uint8_t id) const {
-  return [this, id](Button::Value value) {
-    p->mState.SetButton(id - 1, value);
-    p->mDevice->set(p->mState);
+  return [dev = p->mDevice, id](Button::Value value) {
+    dev->setButton(id, value);
   };
 }
 
-static constexpr int8_t ConvertHatValue(Hat::Value value) {
-  if (value == Hat::CENTER) {
-    return 0b1111;
-  }
-  return value / 4500;
-}
-
 HatSinkPtr MappableFAVHIDOutput::hat(uint8_t id) const {
-  return [this, id](Hat::Value value) {
-    p->mState.SetPOV(id - 1, ConvertHatValue(value));
-    p->mDevice->set(p->mState);
+  return [dev = p->mDevice, id](Hat::Value value) {
+    dev->setHat(id, to_favhid_hat(value));
   };
 }
 
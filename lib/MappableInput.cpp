@@ -10,16 +10,20 @@
 #include <cpp-remapper/InputDevice.h>
 #include <cpp-remapper/MappableInput.h>
 
+#include <algorithm>
+#include <concepts>
 #include <format>
 
 namespace fredemmott::inputmapping {
 
 namespace {
-template <class Source>
-class MISource : public Source {
- public:
-  using Source::emit;
-};
+void warn_missing(const std::string& device, const std::string& control) {
+  printf(
+    "WARNING: Attempted to attach to '%s', but that does not exist on '%s'. "
+    "Ignoring.\n",
+    control.c_str(),
+    device.c_str());
+}
 
 template <typename TControl>
 class MissingSource final : public Source<TControl> {
@@ -32,66 +36,89 @@ class MissingSource final : public Source<TControl> {
   }
 
   void setNext(const maybe_shared_ptr<Sink<TControl>>&) override {
-    printf(
-      "WARNING: Attempted to attach to '%s', but that does not exist on '%s'. "
-      "Ignoring.\n",
-      mControl.c_str(),
-      mDevice.c_str());
+    warn_missing(mDevice, mControl);
   }
 };
 
-class MIAxisSource final : public MISource<AxisSource> {};
-class MIButtonSource final : public MISource<ButtonSource> {};
-class MIHatSource final : public MISource<HatSource> {};
-
-template <typename TSource>
-std::vector<std::shared_ptr<TSource>> fill_sources(size_t count) {
-  std::vector<std::shared_ptr<TSource>> ret;
-  for (auto i = 0; i < count; ++i) {
-    ret.push_back(std::make_shared<TSource>());
+template <typename TControl>
+std::string describe_control(uint8_t id, size_t count) {
+  const char* kind = "hat";
+  if constexpr (std::same_as<TControl, Axis>) {
+    kind = "axis";
+  } else if constexpr (std::same_as<TControl, Button>) {
+    kind = "button";
   }
-  return ret;
+  return std::format("{} number {} of {}", kind, id, count);
 }
 
-AxisSourcePtr find_axis(
-  const std::shared_ptr<InputDevice>& device,
-  std::vector<std::shared_ptr<MIAxisSource>> inputs,
-  AxisType t,
-  uint8_t skip = 0) {
-  const auto skip_in = skip;
-
-  const auto info = device->getAxisInformation();
-  for (uint8_t i = 0; i < info.size(); ++i) {
-    if (info[i].type == t) {
-      if (skip == 0) {
-        return inputs.at(i);
-      }
-      --skip;
-    }
-  }
-  auto axis_name = AxisInformation(t).name;
-  if (skip_in) {
-    axis_name += std::format("[{}]", skip_in);
-  }
-  auto product_name = device->getProductName();
-  return std::make_shared<MissingSource<Axis>>(product_name, axis_name);
-}
+// The `ButtonN` and `HatN` members always exist, even if the device has fewer
+const size_t MIN_BUTTON_HANDLES = 128;
+const size_t MIN_HAT_HANDLES = 4;
 }// namespace
 
 class MappableInput::Impl : public EventSource {
  public:
+  // This is what `axis()`, `button()`, `hat()` and the named members point
+  // at; they're stored contiguously, and attaching to one just records the
+  // sink in the Impl.
+  template <typename TControl>
+  class ControlSource final : public Source<TControl> {
+   public:
+    ControlSource(Impl* impl, uint8_t id) : mImpl(impl), mID(id) {
+    }
+
+    void setNext(const maybe_shared_ptr<Sink<TControl>>& next) override {
+      mImpl->attach<TControl>(mID, next);
+    }
+
+   private:
+    Impl* mImpl;
+    uint8_t mID;
+  };
+
+  // Structure-of-arrays, so that polling walks dense memory
+  template <typename TControl>
+  struct Controls {
+    using Value = typename TControl::Value;
+
+    size_t count = 0;
+    // Not `std::vector` so that `std::vector<bool>` doesn't get in the way of
+    // exposing these as spans
+    std::unique_ptr<Value[]> values;
+    // nullptr if nothing is attached
+    std::vector<Sink<TControl>*> next;
+    // Keeps `next` alive; not touched while polling
+    std::vector<maybe_shared_ptr<Sink<TControl>>> nextOwners;
+    std::vector<ControlSource<TControl>> handles;
+  };
+
   std::shared_ptr<InputDevice> device;
-  InputDevice::State state;
-  std::vector<std::shared_ptr<MIAxisSource>> axisInputs;
-  std::vector<std::shared_ptr<MIButtonSource>> buttonInputs;
-  std::vector<std::shared_ptr<MIHatSource>> hatInputs;
+  // The last device passed to `setDevice()` that had different controls
+  std::weak_ptr<InputDevice> mismatched;
+  std::vector<AxisType> axisTypes;
+  Controls<Axis> axes;
+  Controls<Button> buttons;
+  Controls<Hat> hats;
+
   Impl() = delete;
-  Impl(const std::shared_ptr<InputDevice>& dev)
-    : device(dev),
-      state(dev->getState()),
-      axisInputs(fill_sources<MIAxisSource>(dev->getAxisCount())),
-      buttonInputs(fill_sources<MIButtonSource>(dev->getButtonCount())),
-      hatInputs(fill_sources<MIHatSource>(dev->getAxisCount())) {
+  Impl(const std::shared_ptr<InputDevice>& dev) : device(dev) {
+    for (const auto& info: dev->getAxisInformation()) {
+      axisTypes.push_back(info.type);
+    }
+    init(axes, axisTypes.size(), axisTypes.size());
+    init(buttons, dev->getButtonCount(), MIN_BUTTON_HANDLES);
+    init(hats, dev->getHatCount(), MIN_HAT_HANDLES);
+
+    const auto state = dev->getState();
+    for (size_t i = 0; i < axes.count; ++i) {
+      axes.values[i] = state.getAxis(i);
+    }
+    for (size_t i = 0; i < buttons.count; ++i) {
+      buttons.values[i] = state.getButton(i);
+    }
+    for (size_t i = 0; i < hats.count; ++i) {
+      hats.values[i] = state.getHat(i);
+    }
   }
 
   virtual HANDLE getHandle() override {
@@ -99,11 +126,107 @@ class MappableInput::Impl : public EventSource {
   }
 
   virtual void poll() override;
+
+  bool setDevice(const std::shared_ptr<InputDevice>& dev) {
+    if (dev == mismatched.lock()) {
+      // Already warned
+      return false;
+    }
+    const bool sameLayout
+      = std::ranges::equal(
+          dev->getAxisInformation(), axisTypes, {}, &AxisInformation::type)
+      && dev->getButtonCount() == buttons.count
+      && dev->getHatCount() == hats.count;
+    if (!sameLayout) {
+      const auto name = dev->getProductName();
+      printf(
+        "WARNING: '%s' was reconnected with different controls; restart "
+        "the profile to use it.\n",
+        name.c_str());
+      mismatched = dev;
+      return false;
+    }
+    device = dev;
+    // Pass on anything that changed while it was disconnected
+    poll();
+    return true;
+  }
+
+  template <typename TControl>
+  Controls<TControl>& controls() {
+    if constexpr (std::same_as<TControl, Axis>) {
+      return axes;
+    } else if constexpr (std::same_as<TControl, Button>) {
+      return buttons;
+    } else {
+      return hats;
+    }
+  }
+
+  template <typename TControl>
+  static SourcePtr<TControl> get(const std::shared_ptr<Impl>& p, uint8_t id) {
+    auto& controls = p->controls<TControl>();
+    if (id == 0 || id > controls.handles.size()) {
+      return std::make_shared<MissingSource<TControl>>(
+        p->device->getProductName(),
+        describe_control<TControl>(id, controls.count));
+    }
+    // Aliasing constructor: keeps the Impl alive without another allocation
+    return std::shared_ptr<Source<TControl>>(p, &controls.handles[id - 1]);
+  }
+
+  static AxisSourcePtr
+  findAxis(const std::shared_ptr<Impl>& p, AxisType t, uint8_t skip = 0) {
+    const auto skip_in = skip;
+    for (uint8_t i = 0; i < p->axisTypes.size(); ++i) {
+      if (p->axisTypes[i] != t) {
+        continue;
+      }
+      if (skip == 0) {
+        return get<Axis>(p, i + 1);
+      }
+      --skip;
+    }
+    auto axis_name = AxisInformation(t).name;
+    if (skip_in) {
+      axis_name += std::format("[{}]", skip_in);
+    }
+    return std::make_shared<MissingSource<Axis>>(
+      p->device->getProductName(), axis_name);
+  }
+
+ private:
+  template <typename TControl>
+  void init(Controls<TControl>& controls, size_t count, size_t minHandles) {
+    const auto handles = std::max(count, minHandles);
+    controls.count = count;
+    controls.values = std::make_unique<typename TControl::Value[]>(count);
+    controls.next.resize(count);
+    controls.nextOwners.resize(count);
+    controls.handles.reserve(handles);
+    for (size_t i = 1; i <= handles; ++i) {
+      controls.handles.emplace_back(this, static_cast<uint8_t>(i));
+    }
+  }
+
+  template <typename TControl>
+  void attach(uint8_t id, const maybe_shared_ptr<Sink<TControl>>& next) {
+    auto& controls = this->controls<TControl>();
+    if (id > controls.count) {
+      // Only format the diagnostic if it's actually needed
+      warn_missing(
+        device->getProductName(),
+        describe_control<TControl>(id, controls.count));
+      return;
+    }
+    controls.nextOwners[id - 1] = next;
+    controls.next[id - 1] = next.isValid() ? &*next : nullptr;
+  }
 };
 
 MappableInput::MappableInput(const std::shared_ptr<InputDevice>& dev)
   : p(std::make_shared<Impl>(dev)),
-#define A(x) x##Axis(find_axis(dev, p->axisInputs, AxisType::x))
+#define A(x) x##Axis(Impl::findAxis(p, AxisType::x))
     A(X),
     A(Y),
     A(Z),
@@ -111,8 +234,8 @@ MappableInput::MappableInput(const std::shared_ptr<InputDevice>& dev)
     A(RY),
     A(RZ),
 #undef A
-    Slider(find_axis(dev, p->axisInputs, AxisType::SLIDER)),
-    Dial(find_axis(dev, p->axisInputs, AxisType::SLIDER, 1)),
+    Slider(Impl::findAxis(p, AxisType::SLIDER)),
+    Dial(Impl::findAxis(p, AxisType::SLIDER, 1)),
 #define B(x) Button##x(button(x))
     B(1),
     B(2),
@@ -256,84 +379,90 @@ MappableInput::~MappableInput() {
 }
 
 size_t MappableInput::getAxisCount() const {
-  return p->device->getAxisCount();
+  return p->axes.count;
 }
 
 size_t MappableInput::getButtonCount() const {
-  return p->device->getButtonCount();
+  return p->buttons.count;
 }
 
 size_t MappableInput::getHatCount() const {
-  return p->device->getHatCount();
+  return p->hats.count;
 }
 
 std::shared_ptr<EventSource> MappableInput::getEventSource() const {
   return p;
 }
 
-AxisSourcePtr MappableInput::axis(uint8_t id) const {
-  if (id == 0 || id > getAxisCount()) {
-    char buf[255];
-    snprintf(buf, sizeof(buf), "axis number %d of %zu", id, getAxisCount());
-    return std::make_shared<MissingSource<Axis>>(
-      p->device->getProductName(), buf);
-  }
+std::shared_ptr<InputDevice> MappableInput::getDevice() const {
+  return p->device;
+}
 
-  return p->axisInputs.at(id - 1);
+bool MappableInput::setDevice(const std::shared_ptr<InputDevice>& device) {
+  return p->setDevice(device);
 }
 
-ButtonSourcePtr MappableInput::button(uint8_t id) const {
-  if (id == 0 || id > getButtonCount()) {
-    char buf[255];
-    // TODO: snprintf -> std::format
-    snprintf(buf, sizeof(buf), "button number %d of %zu", id, getButtonCount());
-    return std::make_shared<MissingSource<Button>>(
-      p->device->getProductName(), buf);
-  }
+AxisSourcePtr MappableInput::axis(uint8_t id) const {
+  return Impl::get<Axis>(p, id);
+}
 
-  return p->buttonInputs.at(id - 1);
+ButtonSourcePtr MappableInput::button(uint8_t id) const {
+  return Impl::get<Button>(p, id);
 }
 
 HatSourcePtr MappableInput::hat(uint8_t id) const {
-  if (id == 0 || id > getHatCount()) {
-    char buf[255];
-    snprintf(buf, sizeof(buf), "hat number %d of %zu", id, getHatCount());
-    return std::make_shared<MissingSource<Hat>>(
-      p->device->getProductName(), buf);
-  }
-  return p->hatInputs.at(id - 1);
+  return Impl::get<Hat>(p, id);
+}
+
+std::span<const Axis::Value> MappableInput::getAxisValues() const {
+  return {p->axes.values.get(), p->axes.count};
+}
+
+std::span<const Button::Value> MappableInput::getButtonValues() const {
+  return {p->buttons.values.get(), p->buttons.count};
+}
+
+std::span<const Hat::Value> MappableInput::getHatValues() const {
+  return {p->hats.values.get(), p->hats.count};
 }
 
 void MappableInput::Impl::poll() {
-  auto a = state;
-  auto b = device->getState();
-  state = b;
+  const auto state = device->getState();
 
 #ifdef VERBOSE_INPUT_DEBUG
-  printf("-");
-  a.dump();
-  printf("+");
-  b.dump();
+  state.dump();
 #endif
 
-  const auto axes = axisInputs.size(), buttons = buttonInputs.size(),
-             hats = hatInputs.size();
-
-  for (auto i = 0; i < axes; ++i) {
-    if (a.getAxis(i) != b.getAxis(i)) {
-      axisInputs[i]->emit(b.getAxis(i));
+  for (size_t i = 0; i < axes.count; ++i) {
+    const auto value = state.getAxis(i);
+    if (value == axes.values[i]) {
+      continue;
+    }
+    axes.values[i] = value;
+    if (axes.next[i]) {
+      axes.next[i]->map(value);
     }
   }
 
-  for (auto i = 0; i < buttons; ++i) {
-    if (a.getButton(i) != b.getButton(i)) {
-      buttonInputs[i]->emit(b.getButton(i));
+  for (size_t i = 0; i < buttons.count; ++i) {
+    const auto value = state.getButton(i);
+    if (value == buttons.values[i]) {
+      continue;
+    }
+    buttons.values[i] = value;
+    if (buttons.next[i]) {
+      buttons.next[i]->map(value);
     }
   }
 
-  for (auto i = 0; i < hats; ++i) {
-    if (a.getHat(i) != b.getHat(i)) {
-      hatInputs[i]->emit(b.getHat(i));
+  for (size_t i = 0; i < hats.count; ++i) {
+    const auto value = state.getHat(i);
+    if (value == hats.values[i]) {
+      continue;
+    }
+    hats.values[i] = value;
+    if (hats.next[i]) {
+      hats.next[i]->map(value);
     }
   }
 }
@@ -8,17 +8,14 @@
 #include <cpp-remapper/MappableVJoyOutput.h>
 
 #include <cpp-remapper/AxisInformation.h>
-#include <cpp-remapper/InputDevice.h>
+#include <cpp-remapper/ButtonBank.h>
 #include <cpp-remapper/VJoyDevice.h>
 
 namespace fredemmott::inputmapping {
 
-MappableVJoyOutput::MappableVJoyOutput(uint8_t vjoy_id)
-  : MappableVJoyOutput(std::make_shared<VJoyDevice>(vjoy_id)) {
-}
-
 MappableVJoyOutput::MappableVJoyOutput(std::shared_ptr<VJoyDevice> dev)
   : mDevice(dev),
+    mButtons(std::make_shared<ButtonBank>(dev, dev->getButtonWords())),
 #define A(a) a([dev](long value) { dev->set##a(value); })
 #define AA(a) A(a##Axis)
     AA(X),
@@ -178,8 +175,7 @@ std::shared_ptr<OutputDevice> MappableVJoyOutput::getDevice() const {
 }
 
 ButtonSinkPtr MappableVJoyOutput::button(uint8_t id) const {
-  return
-    [dev = mDevice, id](Button::Value value) { dev->setButton(id, value); };
+  return ButtonBank::get(mButtons, id);
 }
 
 HatSinkPtr MappableVJoyOutput::hat(uint8_t id) const {
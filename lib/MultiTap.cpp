@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/MultiTap.h>
+
+#include <algorithm>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+const std::chrono::milliseconds INJECTED_PRESS_DURATION(100);
+}
+
+struct MultiTap::State {
+  using time_point = std::chrono::steady_clock::time_point;
+
+  std::vector<ButtonSinkPtr> handlers;
+  std::chrono::steady_clock::duration window;
+  SingleTap singleTap;
+  // Highest tap count with a handler
+  size_t maxTaps = 0;
+
+  // Taps in the current gesture
+  size_t taps = 0;
+  bool held = false;
+  // `handlers[0]` is following the button (`SingleTap::IMMEDIATE`)
+  bool passthrough = false;
+  // 1-based handler index that is pressed until the button is released
+  size_t holding = 0;
+  // 1-based handler index that is pressed until `pulseEnd`
+  size_t pulsing = 0;
+
+  // `{}` if not pending
+  time_point gestureEnd {};
+  time_point pulseEnd {};
+  // When the one outstanding timer fires; `{}` if there isn't one
+  time_point timerAt {};
+
+  static void arm(const std::shared_ptr<State>& self, time_point now) {
+    time_point next {};
+    for (const auto when: {self->gestureEnd, self->pulseEnd}) {
+      if (when != time_point {} && (next == time_point {} || when < next)) {
+        next = when;
+      }
+    }
+    if (next == time_point {}) {
+      return;
+    }
+    // If the existing timer fires first, it re-arms itself when it does
+    if (self->timerAt != time_point {} && self->timerAt <= next) {
+      return;
+    }
+    self->timerAt = next;
+    Clock::get()->setTimer(next - now, [weak = std::weak_ptr(self), next]() {
+      auto state = weak.lock();
+      // Superseded by an earlier timer
+      if (!state || state->timerAt != next) {
+        return;
+      }
+      state->timerAt = {};
+      const auto fired = std::max(Clock::get()->now(), next);
+      if (state->pulseEnd != time_point {} && state->pulseEnd <= fired) {
+        state->endPulse();
+      }
+      if (state->gestureEnd != time_point {} && state->gestureEnd <= fired) {
+        state->finishGesture(fired);
+      }
+      arm(state, fired);
+    });
+  }
+
+  void endPulse() {
+    if (pulsing) {
+      handlers[pulsing - 1]->map(false);
+    }
+    pulsing = 0;
+    pulseEnd = {};
+  }
+
+  void finishGesture(time_point now) {
+    const auto count = taps;
+    taps = 0;
+    gestureEnd = {};
+
+    // Already sent
+    if (count == 1 && singleTap == SingleTap::IMMEDIATE) {
+      return;
+    }
+    const auto& next = handlers[count - 1];
+    if (!next.isValid()) {
+      return;
+    }
+    if (held) {
+      holding = count;
+      next->map(true);
+      return;
+    }
+    endPulse();
+    pulsing = count;
+    pulseEnd = now + INJECTED_PRESS_DURATION;
+    next->map(true);
+  }
+};
+
+MultiTap::MultiTap(
+  const std::vector<ButtonSinkPtr>& handlers,
+  std::chrono::steady_clock::duration window,
+  SingleTap singleTap)
+  : p(std::make_shared<State>()) {
+  p->handlers = handlers;
+  p->window = window;
+  p->singleTap = singleTap;
+  for (size_t i = 0; i < handlers.size(); ++i) {
+    if (handlers[i].isValid()) {
+      p->maxTaps = i + 1;
+    }
+  }
+}
+
+MultiTap::~MultiTap() {
+}
+
+void MultiTap::map(Button::Value pressed) {
+  if (pressed == p->held) {
+    return;
+  }
+  p->held = pressed;
+  const auto now = Clock::get()->now();
+
+  if (pressed) {
+    if (p->maxTaps == 0) {
+      return;
+    }
+    ++p->taps;
+    if (
+      p->taps == 1 && p->singleTap == SingleTap::IMMEDIATE
+      && p->handlers[0].isValid()) {
+      p->passthrough = true;
+      p->handlers[0]->map(true);
+    }
+    if (p->taps == p->maxTaps) {
+      p->finishGesture(now);
+    } else {
+      p->gestureEnd = now + p->window;
+    }
+    State::arm(p, now);
+    return;
+  }
+
+  if (p->passthrough) {
+    p->passthrough = false;
+    p->handlers[0]->map(false);
+  }
+  if (p->holding) {
+    p->handlers[p->holding - 1]->map(false);
+    p->holding = 0;
+  }
+  if (p->taps == 0) {
+    return;
+  }
+  p->gestureEnd = now + p->window;
+  State::arm(p, now);
+}
+
+}// namespace fredemmott::inputmapping
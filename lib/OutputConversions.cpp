@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/OutputConversions.h>
+
+namespace fredemmott::inputmapping::detail {
+
+namespace {
+template <auto F>
+constexpr auto make_table() {
+  ConversionTable<decltype(F(0))> table {};
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = F(static_cast<uint16_t>(i));
+  }
+  return table;
+}
+}// namespace
+
+// This needs a higher constexpr step limit than MSVC's default; see
+// lib/CMakeLists.txt
+constexpr ConversionTable<uint16_t> VJOY_AXIS_TABLE
+  = make_table<compute_vjoy_axis>();
+constexpr ConversionTable<uint8_t> UINT8_AXIS_TABLE
+  = make_table<compute_uint8_axis>();
+constexpr ConversionTable<int16_t> FAVHID_AXIS_TABLE
+  = make_table<compute_favhid_axis>();
+constexpr ConversionTable<int8_t> FAVHID_HAT_TABLE
+  = make_table<compute_favhid_hat>();
+
+}// namespace fredemmott::inputmapping::detail
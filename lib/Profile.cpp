@@ -8,9 +8,11 @@
 #include <cpp-remapper/Profile.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 
 #include <cpp-remapper/EventLoop.h>
+#include <cpp-remapper/HIDDeviceNotifier.h>
 #include <cpp-remapper/HidHide.h>
 #include <cpp-remapper/InputDevice.h>
 #include <cpp-remapper/InputDeviceCollection.h>
@@ -24,17 +26,59 @@ using namespace fredemmott::inputmapping;
 namespace fredemmott::inputmapping {
 struct Profile::Impl {
   std::shared_ptr<EventLoop> EventLoop;
+  std::unique_ptr<InputDeviceCollection> devices;
   std::unique_ptr<HidHide> guardian;
+  std::vector<std::pair<DeviceSpecifier, MappableInput>> inputs {};
+  std::shared_ptr<DeviceNotifier> notifier {};
+
+  void onDevicesChanged();
 };
 
+void Profile::Impl::onDevicesChanged() {
+  const auto start = std::chrono::steady_clock::now();
+  const auto changes = devices->rescan();
+  for (const auto& device: changes.removed) {
+    const auto name = device->getProductName();
+    printf("Lost \"%s\"; waiting for it to be reconnected.\n", name.c_str());
+  }
+  if (changes.added.empty()) {
+    return;
+  }
+
+  guardian->update(*devices);
+  size_t reconnected = 0;
+  for (auto& [specifier, input]: inputs) {
+    auto device = devices->get(specifier);
+    if (!device || device == input.getDevice()) {
+      continue;
+    }
+    if (input.setDevice(device)) {
+      ++reconnected;
+    }
+  }
+  if (reconnected == 0) {
+    return;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start);
+  printf(
+    "Reconnected %zu input devices in %lldms\n",
+    reconnected,
+    static_cast<long long>(elapsed.count()));
+}
+
 Profile::Profile(const std::vector<HiddenDevice>& ids) : p(std::make_unique<Impl>()) {
   std::vector<DeviceSpecifier> specifiers;
   std::ranges::transform(ids, std::back_inserter(specifiers), [](auto it) {
     return it.getSpecifier();
   });
+  // Enumerate once, and share the result with HidHide
+  auto devices = std::make_unique<InputDeviceCollection>();
+  auto guardian = std::make_unique<HidHide>(*devices, specifiers);
   *p = {
     std::make_shared<EventLoop>(),
-    std::make_unique<HidHide>(specifiers),
+    std::move(devices),
+    std::move(guardian),
   };
 }
 
@@ -48,7 +92,22 @@ std::shared_ptr<EventLoop> Profile::getEventLoop() const {
   return p->EventLoop;
 }
 
+InputDeviceCollection* Profile::getInputDevices() const {
+  return p->devices.get();
+}
+
+void Profile::trackInput(
+  const DeviceSpecifier& specifier,
+  const MappableInput& input) {
+  p->inputs.push_back({specifier, input});
+}
+
 void Profile::run() {
+  if (!p->inputs.empty()) {
+    p->notifier = std::make_shared<HIDDeviceNotifier>();
+    p->notifier->setCallback([impl = p.get()]() { impl->onDevicesChanged(); });
+    getEventLoop()->addEventSource(p->notifier);
+  }
   getEventLoop()->run();
 }
 
@@ -64,7 +123,8 @@ DeviceSpecifier DeviceWithVisibility::getSpecifier() const {
 
 namespace fredemmott::inputmapping::detail {
 
-MappableInput get_device(InputDeviceCollection* c, const DeviceSpecifier& id) {
+MappableInput
+get_device(Profile* p, InputDeviceCollection* c, const DeviceSpecifier& id) {
   auto device = c->get(id);
   if (!device) {
     auto desc = id.getHumanReadable();
@@ -72,6 +132,7 @@ MappableInput get_device(InputDeviceCollection* c, const DeviceSpecifier& id) {
     exit(0);
   }
   MappableInput ret(device);
+  p->trackInput(id, ret);
   auto name = device->getProductName();
   auto instance_id = device->getInstanceID().getHumanReadable();
   auto hardware_id = device->getHardwareID().getHumanReadable();
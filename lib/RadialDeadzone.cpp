@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/DispatchContext.h>
+#include <cpp-remapper/RadialDeadzone.h>
+
+#include <cmath>
+#include <vector>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+
+// Distance from center of a full deflection along a single axis
+const int64_t FULL_DEFLECTION = 0x8000;
+// Gains are 16.16 fixed-point
+const int GAIN_BITS = 16;
+
+// sqrt(n), rounded to nearest.
+//
+// `n` is at most 2^31, so it's exact as a double, and sqrt() is correctly
+// rounded; (r + 0.5)^2 is never an integer, so there are no ties to get
+// wrong. The rest of the magnitude math is integer; this is about 3x faster
+// than an integer square root (see the "RadialDeadzone square root"
+// benchmark).
+uint32_t rounded_sqrt(uint64_t n) {
+  return static_cast<uint32_t>(std::sqrt(static_cast<double>(n)) + 0.5);
+}
+
+Axis::Value clamp_axis(int64_t value) {
+  if (value < Axis::MIN) {
+    return Axis::MIN;
+  }
+  if (value > Axis::MAX) {
+    return Axis::MAX;
+  }
+  return static_cast<Axis::Value>(value);
+}
+
+}// namespace
+
+struct RadialDeadzone::State {
+  class Input final : public Sink<Axis> {
+   public:
+    Input(State* state, Axis::Value State::*value)
+      : mState(state), mValue(value) {
+    }
+
+    virtual void map(Axis::Value value) override {
+      mState->*mValue = value;
+      mState->deferredUpdate.request();
+    }
+
+   private:
+    State* mState;
+    Axis::Value State::*mValue;
+  };
+
+  Input xInput {this, &State::x};
+  Input yInput {this, &State::y};
+  OutputSource<Axis> xOutput;
+  OutputSource<Axis> yOutput;
+
+  // Output distance / input distance, indexed by input distance from center;
+  // anything further out than the table is passed through unchanged
+  std::vector<uint32_t> gains;
+
+  Axis::Value x = Axis::MID;
+  Axis::Value y = Axis::MID;
+  // Both inputs often change in the same poll; only update once
+  DispatchContext::DeferredUpdate deferredUpdate {[this]() { update(); }};
+
+  State(Percent deadzone, double curviness)
+    : gains(FULL_DEFLECTION + 1, 0) {
+    const double full = FULL_DEFLECTION;
+    const double dead = (deadzone.value() * full) / 100;
+    if (dead >= full) {
+      return;
+    }
+    const double k = curviness;
+    for (int64_t r = 1; r <= FULL_DEFLECTION; ++r) {
+      const double t = (r - dead) / (full - dead);
+      if (t <= 0) {
+        continue;
+      }
+      // Same curve as AxisCurve
+      const auto ft = (t - (t * k)) / (k - (t * 2 * k) + 1);
+      const auto clamped = ft > 1.0 ? 1.0 : (ft < 0.0 ? 0.0 : ft);
+      gains[r] = static_cast<uint32_t>(
+        std::llround((clamped * full * (1 << GAIN_BITS)) / r));
+    }
+  }
+
+  void update() {
+    const int64_t dx = x - Axis::MID;
+    const int64_t dy = y - Axis::MID;
+    const auto distance = rounded_sqrt((dx * dx) + (dy * dy));
+    if (distance >= gains.size()) {
+      xOutput.emit(x);
+      yOutput.emit(y);
+      return;
+    }
+
+    const int64_t gain = gains[distance];
+    const int64_t half = int64_t {1} << (GAIN_BITS - 1);
+    xOutput.emit(clamp_axis(Axis::MID + (((dx * gain) + half) >> GAIN_BITS)));
+    yOutput.emit(clamp_axis(Axis::MID + (((dy * gain) + half) >> GAIN_BITS)));
+  }
+};
+
+RadialDeadzone::RadialDeadzone(Percent deadzone, double curviness)
+  : p(std::make_shared<State>(deadzone, curviness)),
+    XAxis(std::shared_ptr<Sink<Axis>>(p, &p->xInput)),
+    YAxis(std::shared_ptr<Sink<Axis>>(p, &p->yInput)),
+    XOutput(std::shared_ptr<Source<Axis>>(p, &p->xOutput)),
+    YOutput(std::shared_ptr<Source<Axis>>(p, &p->yOutput)) {
+}
+
+RadialDeadzone::~RadialDeadzone() {
+}
+
+RadialCurve::RadialCurve(double curviness)
+  : RadialDeadzone(Percent(0), curviness) {
+}
+
+}// namespace fredemmott::inputmapping
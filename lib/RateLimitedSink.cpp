@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/DispatchContext.h>
+#include <cpp-remapper/RateLimitedSink.h>
+
+namespace fredemmott::inputmapping {
+
+struct RateLimitedSink::State {
+  using time_point = std::chrono::steady_clock::time_point;
+
+  std::shared_ptr<EventSink> next;
+  std::chrono::steady_clock::duration minInterval;
+
+  time_point lastFlush {};
+  bool skipped = false;
+  bool timerPending = false;
+  bool urgent = false;
+  // The event loop flushes everything after a timer fires, in the same
+  // dispatch; that shouldn't count as another flush
+  uint64_t trailingDispatch = 0;
+  Stats stats;
+
+  void flushNext(time_point now) {
+    next->flush();
+    lastFlush = now;
+    skipped = false;
+    urgent = false;
+    ++stats.flushes;
+  }
+};
+
+RateLimitedSink::RateLimitedSink(
+  const std::shared_ptr<EventSink>& next,
+  std::chrono::steady_clock::duration minInterval)
+  : p(std::make_shared<State>()) {
+  p->next = next;
+  p->minInterval = minInterval;
+}
+
+RateLimitedSink::~RateLimitedSink() {
+  // Don't let a pending timer flush after we're gone
+  p->skipped = false;
+}
+
+void RateLimitedSink::flush() {
+  const auto dispatch = DispatchContext::getDispatchID();
+  if (dispatch != 0 && dispatch == p->trailingDispatch) {
+    return;
+  }
+
+  const auto clock = Clock::get();
+  const auto now = clock->now();
+  if (p->urgent) {
+    ++p->stats.prioritized;
+    p->flushNext(now);
+    return;
+  }
+  if (now - p->lastFlush >= p->minInterval) {
+    p->flushNext(now);
+    return;
+  }
+
+  ++p->stats.coalesced;
+  p->skipped = true;
+  if (p->timerPending) {
+    return;
+  }
+  p->timerPending = true;
+  clock->setTimer(
+    p->lastFlush + p->minInterval - now, [weak = std::weak_ptr(p)]() {
+      auto state = weak.lock();
+      if (!state) {
+        return;
+      }
+      state->timerPending = false;
+      if (!state->skipped) {
+        return;
+      }
+      ++state->stats.trailing;
+      state->flushNext(Clock::get()->now());
+      state->trailingDispatch = DispatchContext::getDispatchID();
+    });
+}
+
+ButtonSinkPtr RateLimitedSink::prioritize(const ButtonSinkPtr& next) {
+  return [state = p, next](Button::Value value) {
+    state->urgent = true;
+    next->map(value);
+  };
+}
+
+RateLimitedSink::Stats RateLimitedSink::getStats() const {
+  return p->stats;
+}
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/Sequence.h>
+
+#include <vector>
+
+namespace fredemmott::inputmapping {
+
+struct Sequence::State {
+  enum class Kind : uint8_t { BUTTON, AXIS, HAT, END };
+
+  // Steps are compiled to a flat list of changes, in the order they happen
+  struct Event {
+    duration at;
+    Kind kind;
+    // Index into `buttons`, `axes`, or `hats`
+    uint16_t target;
+    long value;
+  };
+
+  std::vector<Event> events;
+  std::vector<ButtonSinkPtr> buttons;
+  std::vector<AxisSinkPtr> axes;
+  std::vector<HatSinkPtr> hats;
+
+  bool playing = false;
+  // Invalidates the pending timer when cancelled
+  uint64_t generation = 0;
+  std::chrono::steady_clock::time_point start;
+  size_t next = 0;
+
+  // What to undo if cancelled
+  std::vector<bool> buttonsHeld;
+  std::vector<bool> hatsHeld;
+
+  void apply(const Event& event) {
+    switch (event.kind) {
+      case Kind::BUTTON:
+        buttonsHeld[event.target] = event.value;
+        buttons[event.target]->map(event.value);
+        return;
+      case Kind::AXIS:
+        axes[event.target]->map(event.value);
+        return;
+      case Kind::HAT:
+        hatsHeld[event.target] = event.value != Hat::CENTER;
+        hats[event.target]->map(static_cast<Hat::Value>(event.value));
+        return;
+      case Kind::END:
+        return;
+    }
+  }
+
+  // Apply everything that's due, then wait for the next step; this is the
+  // only timer for the sequence.
+  static void run(const std::shared_ptr<State>& self) {
+    const auto now = Clock::get()->now();
+    const auto& events = self->events;
+    while (self->next < events.size()
+           && self->start + events[self->next].at <= now) {
+      self->apply(events[self->next++]);
+    }
+    if (self->next == events.size()) {
+      self->playing = false;
+      return;
+    }
+
+    // Relative to the start, so delays don't accumulate
+    const auto when = self->start + events[self->next].at;
+    Clock::get()->setTimer(
+      when - now,
+      [weak = std::weak_ptr(self), generation = self->generation]() {
+        auto state = weak.lock();
+        if (!state || !state->playing || state->generation != generation) {
+          return;
+        }
+        run(state);
+      });
+  }
+};
+
+Sequence::Step Sequence::press(const ButtonSinkPtr& button, duration length) {
+  Step ret;
+  ret.kind = Step::Kind::PRESS;
+  ret.button = button;
+  ret.length = length;
+  return ret;
+}
+
+Sequence::Step
+Sequence::hat(const HatSinkPtr& hat, Hat::Value value, duration length) {
+  Step ret;
+  ret.kind = Step::Kind::HAT;
+  ret.hat = hat;
+  ret.value = value;
+  ret.length = length;
+  return ret;
+}
+
+Sequence::Step Sequence::axis(const AxisSinkPtr& axis, Axis::Value value) {
+  Step ret;
+  ret.kind = Step::Kind::AXIS;
+  ret.axis = axis;
+  ret.value = value;
+  return ret;
+}
+
+Sequence::Step Sequence::wait(duration length) {
+  Step ret;
+  ret.length = length;
+  return ret;
+}
+
+Sequence::Sequence(std::initializer_list<Step> steps)
+  : p(std::make_shared<State>()) {
+  using Kind = State::Kind;
+  duration at {};
+  for (const auto& step: steps) {
+    switch (step.kind) {
+      case Step::Kind::WAIT:
+        break;
+      case Step::Kind::PRESS: {
+        const auto target = static_cast<uint16_t>(p->buttons.size());
+        p->buttons.push_back(step.button);
+        p->events.push_back({at, Kind::BUTTON, target, true});
+        p->events.push_back({at + step.length, Kind::BUTTON, target, false});
+        break;
+      }
+      case Step::Kind::AXIS: {
+        const auto target = static_cast<uint16_t>(p->axes.size());
+        p->axes.push_back(step.axis);
+        p->events.push_back({at, Kind::AXIS, target, step.value});
+        break;
+      }
+      case Step::Kind::HAT: {
+        const auto target = static_cast<uint16_t>(p->hats.size());
+        p->hats.push_back(step.hat);
+        p->events.push_back({at, Kind::HAT, target, step.value});
+        p->events.push_back(
+          {at + step.length, Kind::HAT, target, Hat::CENTER});
+        break;
+      }
+    }
+    at += step.length;
+  }
+  // Trailing waits still count towards how long the sequence plays for
+  p->events.push_back({at, Kind::END, 0, 0});
+  p->buttonsHeld.resize(p->buttons.size());
+  p->hatsHeld.resize(p->hats.size());
+}
+
+Sequence::~Sequence() {
+}
+
+void Sequence::map(Button::Value pressed) {
+  if (!pressed || p->playing) {
+    return;
+  }
+  p->playing = true;
+  ++p->generation;
+  p->start = Clock::get()->now();
+  p->next = 0;
+  State::run(p);
+}
+
+bool Sequence::isPlaying() const {
+  return p->playing;
+}
+
+void Sequence::cancel() {
+  if (!p->playing) {
+    return;
+  }
+  p->playing = false;
+  ++p->generation;
+  for (size_t i = 0; i < p->buttons.size(); ++i) {
+    if (p->buttonsHeld[i]) {
+      p->buttonsHeld[i] = false;
+      p->buttons[i]->map(false);
+    }
+  }
+  for (size_t i = 0; i < p->hats.size(); ++i) {
+    if (p->hatsHeld[i]) {
+      p->hatsHeld[i] = false;
+      p->hats[i]->map(Hat::CENTER);
+    }
+  }
+}
+
+}// namespace fredemmott::inputmapping
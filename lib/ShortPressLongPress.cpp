@@ -13,13 +13,24 @@ namespace fredemmott::inputmapping {
 
 namespace {
 const std::chrono::milliseconds INJECTED_PRESS_DURATION(100);
+
+void inject_press(const ButtonSinkPtr& next) {
+  next->map(true);
+  Clock::get()->setTimer(
+    INJECTED_PRESS_DURATION, [next]() { next->map(false); });
 }
+}// namespace
 
 ShortPressLongPress::ShortPressLongPress(
   ButtonSinkPtr s,
   ButtonSinkPtr l,
-  std::chrono::steady_clock::duration long_duration)
-  : mShortPress(s), mLongPress(l), mLongDuration(long_duration) {
+  std::chrono::steady_clock::duration long_duration,
+  LongPressMode mode)
+  : mShortPress(s),
+    mLongPress(l),
+    mLongDuration(long_duration),
+    mMode(mode),
+    mState(std::make_shared<State>()) {
 }
 
 void ShortPressLongPress::map(bool pressed) {
@@ -27,6 +38,29 @@ void ShortPressLongPress::map(bool pressed) {
   const auto now = clock->now();
   if (pressed) {
     mStart = now;
+    if (mMode == LongPressMode::ON_RELEASE) {
+      return;
+    }
+    const auto generation = ++mState->generation;
+    mState->longPressed = false;
+    clock->setTimer(
+      mLongDuration,
+      [weakState = std::weak_ptr(mState),
+       generation,
+       next = mLongPress,
+       hold = mMode == LongPressMode::AT_THRESHOLD_UNTIL_RELEASE]() {
+        auto state = weakState.lock();
+        // Released or destroyed since
+        if (!state || state->generation != generation) {
+          return;
+        }
+        state->longPressed = true;
+        if (hold) {
+          next->map(true);
+        } else {
+          inject_press(next);
+        }
+      });
     return;
   }
 
@@ -35,13 +69,24 @@ void ShortPressLongPress::map(bool pressed) {
     return;
   }
 
+  if (mMode != LongPressMode::ON_RELEASE) {
+    ++mState->generation;
+    if (mState->longPressed) {
+      mState->longPressed = false;
+      if (mMode == LongPressMode::AT_THRESHOLD_UNTIL_RELEASE) {
+        mLongPress->map(false);
+      }
+      return;
+    }
+    // The threshold timer might not have been handled yet even though it's
+    // due, e.g. because input events are handled first; go by the time
+    // instead.
+  }
+
   if (now - mStart < mLongDuration) {
-    mShortPress->map(true);
-    clock->setTimer(
-      INJECTED_PRESS_DURATION, [=]() { mShortPress->map(false); });
+    inject_press(mShortPress);
   } else {
-    mLongPress->map(true);
-    clock->setTimer(INJECTED_PRESS_DURATION, [=]() { mLongPress->map(false); });
+    inject_press(mLongPress);
   }
 }
 
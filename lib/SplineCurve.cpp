@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/SplineCurve.h>
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+
+using Point = SplineCurve::Point;
+using Table = std::array<uint16_t, Axis::MAX + 1>;
+
+// Tables are only kept alive by the curves using them
+std::mutex gTablesMutex;
+std::map<std::vector<Point>, std::weak_ptr<const Table>> gTables;
+
+void validate(const std::vector<Point>& points) {
+  if (points.size() < 2) {
+    throw std::invalid_argument(std::format(
+      "SplineCurve needs at least 2 points, but got {}", points.size()));
+  }
+  bool increasing = false;
+  bool decreasing = false;
+  for (size_t i = 0; i < points.size(); ++i) {
+    const auto& point = points[i];
+    if (
+      point.in < Axis::MIN || point.in > Axis::MAX || point.out < Axis::MIN
+      || point.out > Axis::MAX) {
+      throw std::invalid_argument(std::format(
+        "SplineCurve point {} ({}, {}) is out of range",
+        i,
+        point.in,
+        point.out));
+    }
+    if (i == 0) {
+      continue;
+    }
+    const auto& prev = points[i - 1];
+    if (point.in <= prev.in) {
+      throw std::invalid_argument(std::format(
+        "SplineCurve point {} has input {}, which is not after {}",
+        i,
+        point.in,
+        prev.in));
+    }
+    increasing |= point.out > prev.out;
+    decreasing |= point.out < prev.out;
+  }
+  if (increasing && decreasing) {
+    throw std::invalid_argument(
+      "SplineCurve outputs must never decrease, or never increase");
+  }
+}
+
+// Slope at each point for a monotone piecewise cubic Hermite spline
+// (Fritsch-Butland); this is what makes sure the curve doesn't overshoot
+std::vector<double> get_tangents(const std::vector<Point>& points) {
+  const auto count = points.size();
+  std::vector<double> widths(count - 1);
+  std::vector<double> slopes(count - 1);
+  for (size_t i = 0; i + 1 < count; ++i) {
+    widths[i] = points[i + 1].in - points[i].in;
+    slopes[i] = (points[i + 1].out - points[i].out) / widths[i];
+  }
+
+  std::vector<double> tangents(count);
+  tangents.front() = slopes.front();
+  tangents.back() = slopes.back();
+  for (size_t i = 1; i + 1 < count; ++i) {
+    const auto before = slopes[i - 1];
+    const auto after = slopes[i];
+    if (before * after <= 0) {
+      // Flat, or a local extreme
+      continue;
+    }
+    // Weighted harmonic mean
+    const auto w1 = (2 * widths[i]) + widths[i - 1];
+    const auto w2 = widths[i] + (2 * widths[i - 1]);
+    tangents[i] = (w1 + w2) / ((w1 / before) + (w2 / after));
+  }
+  return tangents;
+}
+
+std::shared_ptr<const Table> get_table(const std::vector<Point>& points) {
+  std::unique_lock lock(gTablesMutex);
+  if (auto existing = gTables[points].lock()) {
+    return existing;
+  }
+
+  auto table = std::make_shared<Table>();
+  const auto tangents = get_tangents(points);
+  for (Axis::Value x = Axis::MIN; x <= points.front().in; ++x) {
+    (*table)[x] = static_cast<uint16_t>(points.front().out);
+  }
+  for (size_t i = 0; i + 1 < points.size(); ++i) {
+    const auto& a = points[i];
+    const auto& b = points[i + 1];
+    const double width = b.in - a.in;
+    const auto low = std::min(a.out, b.out);
+    const auto high = std::max(a.out, b.out);
+    for (auto x = a.in + 1; x <= b.in; ++x) {
+      // Cubic Hermite basis functions
+      const auto t = (x - a.in) / width;
+      const auto t2 = t * t;
+      const auto t3 = t2 * t;
+      const auto y = (((2 * t3) - (3 * t2) + 1) * a.out)
+        + ((t3 - (2 * t2) + t) * width * tangents[i])
+        + (((-2 * t3) + (3 * t2)) * b.out)
+        + ((t3 - t2) * width * tangents[i + 1]);
+      // Monotone in exact maths, but make sure rounding can't undo that
+      const auto rounded = std::lround(y);
+      (*table)[x] = static_cast<uint16_t>(
+        rounded < low ? low : (rounded > high ? high : rounded));
+    }
+  }
+  for (auto x = points.back().in + 1; x <= Axis::MAX; ++x) {
+    (*table)[x] = static_cast<uint16_t>(points.back().out);
+  }
+
+  std::erase_if(gTables, [](const auto& it) { return it.second.expired(); });
+  gTables[points] = table;
+  return table;
+}
+
+}// namespace
+
+SplineCurve::SplineCurve(std::initializer_list<Point> points)
+  : SplineCurve(std::vector<Point>(points)) {
+}
+
+SplineCurve::SplineCurve(const std::vector<Point>& points) {
+  validate(points);
+  mTable = get_table(points);
+}
+
+SplineCurve::~SplineCurve() {
+}
+
+void SplineCurve::map(Axis::Value value) {
+  const auto clamped = value < Axis::MIN
+    ? Axis::MIN
+    : (value > Axis::MAX ? Axis::MAX : value);
+  emit((*mTable)[clamped]);
+}
+
+size_t SplineCurve::getTableCount() {
+  std::unique_lock lock(gTablesMutex);
+  std::erase_if(gTables, [](const auto& it) { return it.second.expired(); });
+  return gTables.size();
+}
+
+}// namespace fredemmott::inputmapping
@@ -10,30 +10,50 @@
 
 namespace fredemmott::inputmapping {
 
-SquareDeadzone::SquareDeadzone(const Percent& percent)
-  : mPercent(percent.value()) {
+SquareDeadzone::SquareDeadzone(const Percent& percent) {
+  // Re-scale to 100x to avoid dividing by 100 all over the place when dealing
+  // with percentages
+  const uint64_t MAX = 0xffff * 100;
+  const uint64_t MID = MAX / 2;
+  const uint64_t DEAD = (percent.value() * MID) / 100;
+
+  if (DEAD >= MID) {
+    // Everything is in the deadzone
+    mDeadzoneMin = -1;
+    mDeadzoneMax = 0x10000;
+    mScale = 0;
+    mOffset = 0;
+    return;
+  }
+
+  // `value * 100 > MID - DEAD` and `value * 100 < MID + DEAD`, without the
+  // multiplication
+  mDeadzoneMin = static_cast<Axis::Value>((MID - DEAD) / 100);
+  mDeadzoneMax = static_cast<Axis::Value>((MID + DEAD + 99) / 100);
+
+  // Outside of the deadzone, the result is
+  //
+  //   (((value * 100) - offset) * MAX / NEW_MAX) / 100
+  //
+  // ... where offset is 0 below the midpoint, and 2 * DEAD above it. Rounding
+  // the reciprocal up gives the same results as dividing for all 65536
+  // inputs and all percentages; this is checked by the tests.
+  const uint64_t NEW_MAX = (MAX - (2 * DEAD)) * 100;
+  const uint64_t scale = ((MAX << 32) + NEW_MAX - 1) / NEW_MAX;
+  mScale = 100 * scale;
+  mOffset = 2 * DEAD * scale;
 }
 
 SquareDeadzone::~SquareDeadzone() {
 }
 
 void SquareDeadzone::map(long value) {
-  // Re-scale to 100x to avoid dividing by 100 all over the place when dealing
-  // with percentages
-  value *= 100;
-  const uint32_t MAX = 0xffff * 100;
-  const uint32_t MID = MAX / 2;
-  const uint32_t DEAD = (mPercent * MID) / 100;
-  if (value > (MID - DEAD) && value < (MID + DEAD)) {
-    emit(MID / 100);
+  if (value > mDeadzoneMin && value < mDeadzoneMax) {
+    emit(0x7fff);
     return;
   }
-  const uint32_t NEW_MAX = MAX - (2 * DEAD);
-  const uint32_t without_deadzone = (value < MID) ? value : value - (2 * DEAD);
-  // We end up with a temporary where the value is multiplied by 100 * MAX
-  // * NEW_MAX; if the percentage is large, this overflows the uint32
-  const uint32_t scaled = (without_deadzone * (uint64_t)MAX) / NEW_MAX;
-  emit(scaled / 100);
+  const uint64_t offset = value < 0x8000 ? 0 : mOffset;
+  emit(static_cast<long>((value * mScale - offset) >> 32));
 }
 
 }// namespace fredemmott::inputmapping
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/Turbo.h>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace fredemmott::inputmapping {
+
+struct Turbo::State {
+  using time_point = std::chrono::steady_clock::time_point;
+
+  // Stored here instead of in `Source` so that the timer can reach it
+  maybe_shared_ptr<Sink<Button>> next;
+  std::chrono::steady_clock::duration period;
+  std::chrono::steady_clock::duration pressedTime;
+
+  bool held = false;
+  bool pressed = false;
+  // Invalidates the pending timer on release
+  uint64_t generation = 0;
+  time_point start;
+
+  void set(bool value) {
+    if (value == pressed) {
+      return;
+    }
+    pressed = value;
+    if (next.isValid()) {
+      next->map(value);
+    }
+  }
+
+  // Works out where we should be from the start time rather than from the
+  // previous deadline, so a late timer only delays one edge
+  static void update(const std::shared_ptr<State>& self, time_point now) {
+    const auto intoCycle = (now - self->start) % self->period;
+    const auto cycleStart = now - intoCycle;
+    const bool pressed = intoCycle < self->pressedTime;
+    self->set(pressed);
+
+    const auto deadline = pressed ? (cycleStart + self->pressedTime)
+                                  : (cycleStart + self->period);
+    Clock::get()->setTimer(
+      deadline - now,
+      [weak = std::weak_ptr(self), generation = self->generation, deadline]() {
+        auto state = weak.lock();
+        if (!state || state->generation != generation) {
+          return;
+        }
+        update(state, std::max(Clock::get()->now(), deadline));
+      });
+  }
+};
+
+Turbo::Turbo(std::chrono::steady_clock::duration period, float dutyCycle)
+  : p(std::make_shared<State>()) {
+  if (period <= std::chrono::steady_clock::duration::zero()) {
+    throw std::invalid_argument(std::format(
+      "Turbo period must be positive, but got {}ns",
+      std::chrono::nanoseconds(period).count()));
+  }
+  p->period = period;
+  p->pressedTime
+    = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      period * std::clamp(dutyCycle, 0.0f, 1.0f));
+}
+
+Turbo::~Turbo() {
+}
+
+void Turbo::setNext(const maybe_shared_ptr<Sink<Button>>& next) {
+  p->next = next;
+}
+
+void Turbo::map(Button::Value held) {
+  if (held == p->held) {
+    return;
+  }
+  p->held = held;
+  ++p->generation;
+
+  if (!held) {
+    p->set(false);
+    return;
+  }
+
+  const auto now = Clock::get()->now();
+  p->start = now;
+  State::update(p, now);
+}
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/Controls.h>
+#include <cpp-remapper/UInputDevice.h>
+
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+
+// X, Y, Z, RX, RY, RZ, slider, dial
+constexpr std::array<uint16_t, 8> AXIS_CODES {
+  ABS_X,
+  ABS_Y,
+  ABS_Z,
+  ABS_RX,
+  ABS_RY,
+  ABS_RZ,
+  ABS_THROTTLE,
+  ABS_RUDDER,
+};
+
+struct ButtonCodeRange {
+  uint16_t first;
+  uint16_t count;
+};
+
+// Linux doesn't have 128 joystick buttons, so also use other ranges that
+// don't make udev think we're a mouse, keyboard, or tablet.
+//
+// This is the order SDL numbers them in: ascending from BTN_JOYSTICK, then
+// BTN_MISC. SDL stops before KEY_MAX, so that's replaced by BTN_DPAD_UP.
+constexpr std::array<ButtonCodeRange, 6> BUTTON_CODE_RANGES {{
+  {BTN_JOYSTICK, 16},
+  {BTN_GAMEPAD, 16},
+  {BTN_WHEEL, 16},
+  {BTN_DPAD_UP, 1},
+  {BTN_TRIGGER_HAPPY, KEY_MAX - BTN_TRIGGER_HAPPY},
+  {BTN_MISC, 16},
+}};
+
+static_assert([] {
+  size_t count = 0;
+  for (const auto& range: BUTTON_CODE_RANGES) {
+    count += range.count;
+  }
+  return count;
+}() == UInputDevice::BUTTON_COUNT);
+
+// Hats are reported as a pair of -1..1 axes
+constexpr uint16_t hat_x_code(uint8_t hat) {
+  return ABS_HAT0X + (2 * hat);
+}
+
+struct HatPosition {
+  int8_t x;
+  int8_t y;
+};
+
+constexpr HatPosition hat_position(Hat::Value value) {
+  if (value == Hat::CENTER) {
+    return {0, 0};
+  }
+  // N, NE, E, SE, S, SW, W, NW; negative Y is up
+  constexpr HatPosition octants[] {
+    {0, -1},
+    {1, -1},
+    {1, 0},
+    {1, 1},
+    {0, 1},
+    {-1, 1},
+    {-1, 0},
+    {-1, -1},
+  };
+  return octants[((value + (Hat::NORTH_EAST / 2)) / Hat::NORTH_EAST) % 8];
+}
+
+void print_errno(const char* what) {
+  fprintf(stderr, "uinput: %s failed: %s\n", what, strerror(errno));
+}
+
+}// namespace
+
+struct UInputDevice::Impl final {
+  struct State {
+    std::array<int32_t, AXIS_CODES.size()> axes;
+    std::array<HatPosition, HAT_COUNT> hats;
+    std::bitset<BUTTON_COUNT> buttons;
+  };
+
+  int fd = -1;
+  // True if we created the uinput device, and need to clean it up
+  bool ownsFD = false;
+  State state {};
+  State sent {};
+  // Reused by every `flush()` so that it doesn't allocate
+  std::vector<input_event> events;
+
+  Impl() {
+    state.axes.fill(Axis::MID);
+    state.hats.fill({0, 0});
+    sent = state;
+    events.reserve(
+      AXIS_CODES.size() + (2 * HAT_COUNT) + BUTTON_COUNT + /* SYN */ 1);
+  }
+
+  void push(uint16_t type, uint16_t code, int32_t value) {
+    input_event event {};
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    events.push_back(event);
+  }
+
+  bool create(const std::string& name);
+};
+
+bool UInputDevice::Impl::create(const std::string& name) {
+  fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    print_errno("opening /dev/uinput");
+    return false;
+  }
+  ownsFD = true;
+
+  if (
+    ioctl(fd, UI_SET_EVBIT, EV_KEY) < 0
+    || ioctl(fd, UI_SET_EVBIT, EV_ABS) < 0) {
+    print_errno("UI_SET_EVBIT");
+    return false;
+  }
+  for (uint8_t i = 1; i <= BUTTON_COUNT; ++i) {
+    if (ioctl(fd, UI_SET_KEYBIT, getButtonCode(i)) < 0) {
+      print_errno("UI_SET_KEYBIT");
+      return false;
+    }
+  }
+
+  auto add_abs = [this](uint16_t code, int32_t min, int32_t max, int32_t init) {
+    uinput_abs_setup abs {};
+    abs.code = code;
+    abs.absinfo.minimum = min;
+    abs.absinfo.maximum = max;
+    abs.absinfo.value = init;
+    return ioctl(fd, UI_SET_ABSBIT, code) >= 0
+      && ioctl(fd, UI_ABS_SETUP, &abs) >= 0;
+  };
+  for (const auto code: AXIS_CODES) {
+    if (!add_abs(code, Axis::MIN, Axis::MAX, Axis::MID)) {
+      print_errno("UI_ABS_SETUP");
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < HAT_COUNT; ++i) {
+    if (!(add_abs(hat_x_code(i), -1, 1, 0)
+          && add_abs(hat_x_code(i) + 1, -1, 1, 0))) {
+      print_errno("UI_ABS_SETUP");
+      return false;
+    }
+  }
+
+  uinput_setup setup {};
+  setup.id.bustype = BUS_VIRTUAL;
+  // pid.codes test VID/PID
+  setup.id.vendor = 0x1209;
+  setup.id.product = 0x0001;
+  setup.id.version = 1;
+  strncpy(setup.name, name.c_str(), UINPUT_MAX_NAME_SIZE - 1);
+  if (ioctl(fd, UI_DEV_SETUP, &setup) < 0) {
+    print_errno("UI_DEV_SETUP");
+    return false;
+  }
+  if (ioctl(fd, UI_DEV_CREATE) < 0) {
+    print_errno("UI_DEV_CREATE");
+    return false;
+  }
+  return true;
+}
+
+UInputDevice::UInputDevice(const std::string& name) : p(new Impl()) {
+  if (p->create(name)) {
+    printf("Created uinput device '%s'.\n", name.c_str());
+    return;
+  }
+  if (p->fd >= 0) {
+    close(p->fd);
+  }
+  p->fd = -1;
+  p->ownsFD = false;
+}
+
+UInputDevice::UInputDevice(int fd) : p(new Impl()) {
+  p->fd = fd;
+}
+
+UInputDevice::~UInputDevice() {
+  if (!p->ownsFD) {
+    return;
+  }
+  ioctl(p->fd, UI_DEV_DESTROY);
+  close(p->fd);
+}
+
+uint16_t UInputDevice::getButtonCode(uint8_t button) {
+  assert(button >= 1 && button <= BUTTON_COUNT);
+  uint16_t offset = button - 1;
+  for (const auto& range: BUTTON_CODE_RANGES) {
+    if (offset < range.count) {
+      return range.first + offset;
+    }
+    offset -= range.count;
+  }
+  return 0;
+}
+
+void UInputDevice::flush() {
+  if (p->fd < 0) {
+    return;
+  }
+
+  auto& state = p->state;
+  auto& sent = p->sent;
+  p->events.clear();
+
+  for (size_t i = 0; i < AXIS_CODES.size(); ++i) {
+    if (state.axes[i] != sent.axes[i]) {
+      p->push(EV_ABS, AXIS_CODES[i], state.axes[i]);
+    }
+  }
+  for (uint8_t i = 0; i < HAT_COUNT; ++i) {
+    if (state.hats[i].x != sent.hats[i].x) {
+      p->push(EV_ABS, hat_x_code(i), state.hats[i].x);
+    }
+    if (state.hats[i].y != sent.hats[i].y) {
+      p->push(EV_ABS, hat_x_code(i) + 1, state.hats[i].y);
+    }
+  }
+  const auto changedButtons = state.buttons ^ sent.buttons;
+  if (changedButtons.any()) {
+    for (uint8_t i = 0; i < BUTTON_COUNT; ++i) {
+      if (changedButtons.test(i)) {
+        p->push(EV_KEY, getButtonCode(i + 1), state.buttons.test(i));
+      }
+    }
+  }
+
+  if (p->events.empty()) {
+    return;
+  }
+  p->push(EV_SYN, SYN_REPORT, 0);
+
+  const auto bytes = p->events.size() * sizeof(input_event);
+  const auto written = write(p->fd, p->events.data(), bytes);
+  if (written != static_cast<ssize_t>(bytes)) {
+    // Leave `sent` alone so that we try again next time
+    print_errno("write");
+    return;
+  }
+  sent = state;
+}
+
+#define AXIS_SETTER(name, index) \
+  UInputDevice* UInputDevice::set##name(long value) { \
+    p->state.axes[index] = value; \
+    return this; \
+  }
+AXIS_SETTER(XAxis, 0)
+AXIS_SETTER(YAxis, 1)
+AXIS_SETTER(ZAxis, 2)
+AXIS_SETTER(RXAxis, 3)
+AXIS_SETTER(RYAxis, 4)
+AXIS_SETTER(RZAxis, 5)
+AXIS_SETTER(Slider, 6)
+AXIS_SETTER(Dial, 7)
+#undef AXIS_SETTER
+
+UInputDevice* UInputDevice::setButton(uint8_t button, bool value) {
+  if (button < 1 || button > BUTTON_COUNT) {
+    return this;
+  }
+  p->state.buttons.set(button - 1, value);
+  return this;
+}
+
+UInputDevice* UInputDevice::setHat(uint8_t hat, uint16_t value) {
+  if (hat < 1 || hat > HAT_COUNT) {
+    return this;
+  }
+  p->state.hats[hat - 1] = hat_position(value);
+  return this;
+}
+
+}// namespace fredemmott::inputmapping
@@ -6,67 +6,23 @@
  * in the root directory of this source tree.
  */
 #include <cpp-remapper/Controls.h>
+#include <cpp-remapper/OutputConversions.h>
 #include <cpp-remapper/VJoyDevice.h>
 
 #include <cassert>
-#include <cstdio>
-#include <stdexcept>
 
-// clang-format off
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-// vjoy:
-#include <public.h>
-#include <vjoyinterface.h>
-// clang-format on
+// The vJoy driver backend is in VJoyDriverBackend.cpp; this file does not
+// depend on the vJoy SDK.
 
 namespace fredemmott::inputmapping {
-namespace {
-bool vjoy_initialized = false;
-
-void init_vjoy() {
-  if (vjoy_initialized) {
-    return;
-  }
-  vjoy_initialized = true;
-
-  if (!vJoyEnabled()) {
-    printf("vJoy is not enabled.\n");
-    return;
-  }
-  WORD VerDll, VerDrv;
-  if (!DriverMatch(&VerDll, &VerDrv)) {
-    printf(
-      "---\n"
-      "!!! WARNING !!!\n"
-      "vJoy driver version %04x does not match DLL version %04x\n"
-      "---\n",
-      VerDrv,
-      VerDll);
-  }
-}
-}// namespace
 
 struct VJoyDevice::Impl {
-  BYTE id;
-#if USE_JOYSTICK_API_VERSION == 3
-  JOYSTICK_POSITION_V3 state;
-#elif USE_JOYSTICK_API_VERSION == 2
-  JOYSTICK_POSITION_V2 state;
-#endif
+  std::shared_ptr<Backend> backend;
+  Report report;
 };
 
-VJoyDevice::VJoyDevice(uint8_t id) : p(new Impl {id, {}}) {
-  init_vjoy();
-  AcquireVJD(id);
-  // Just in case the state struct has been extended...
-  ResetVJD(id);
-
-  // ... but we also need to manually initialize our state struct
-  // as we call UpdateVJD() rathe than SetAxis/SetButton
-  memset(&p->state, 0, sizeof(p->state));
-  p->state.bDevice = id;
-
+VJoyDevice::VJoyDevice(const std::shared_ptr<Backend>& backend)
+  : p(new Impl {backend, {}}) {
   setXAxis(Axis::MID);
   setYAxis(Axis::MID);
   setZAxis(Axis::MID);
@@ -85,105 +41,80 @@ VJoyDevice::VJoyDevice(uint8_t id) : p(new Impl {id, {}}) {
 }
 
 VJoyDevice::~VJoyDevice() {
-  RelinquishVJD(p->id);
-}
-
-namespace {
-/* DX gives 0->0xffff
- * VJoy wants 1 -> 0x8000
- */
-long normalize_axis(long dx) {
-  return ((dx * (0x8000 - 1)) / 0xffff) + 1;
 }
-}// namespace
 
 VJoyDevice* VJoyDevice::setXAxis(long value) {
-  p->state.wAxisX = normalize_axis(value);
+  p->report.x = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setYAxis(long value) {
-  p->state.wAxisY = normalize_axis(value);
+  p->report.y = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setZAxis(long value) {
-  p->state.wAxisZ = normalize_axis(value);
+  p->report.z = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setRXAxis(long value) {
-  p->state.wAxisXRot = normalize_axis(value);
+  p->report.rx = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setRYAxis(long value) {
-  p->state.wAxisYRot = normalize_axis(value);
+  p->report.ry = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setRZAxis(long value) {
-  p->state.wAxisZRot = normalize_axis(value);
+  p->report.rz = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setSlider(long value) {
-  p->state.wSlider = normalize_axis(value);
+  p->report.slider = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setDial(long value) {
-  p->state.wDial = normalize_axis(value);
+  p->report.dial = to_vjoy_axis(value);
   return this;
 }
 
 VJoyDevice* VJoyDevice::setButton(uint8_t button, bool value) {
   button--;
-  off_t offset = button % 32;
-  auto mask = 1 << offset;
-
-  LONG* data = nullptr;
-  if (button < 32) {
-    data = &p->state.lButtons;
-  } else if (button < 64) {
-    data = &p->state.lButtonsEx1;
-  } else if (button < 96) {
-    data = &p->state.lButtonsEx2;
-  } else if (button < 128) {
-    data = &p->state.lButtonsEx3;
+  assert(button < 128);
+  if (button >= 128) {
+    return this;
   }
-  assert(data);
 
+  const auto mask = uint32_t {1} << (button % 32);
+  auto& data = p->report.buttons[button / 32];
   if (value) {
-    *data |= mask;
+    data |= mask;
   } else {
-    *data &= ~mask;
+    data &= ~mask;
   }
 
   return this;
 }
 
 VJoyDevice* VJoyDevice::setHat(uint8_t hat, uint16_t v) {
-  const DWORD value = v == Hat::CENTER ? DWORD(-1) : v;
-  switch (hat) {
-    case 1:
-      p->state.bHats = value;
-      break;
-    case 2:
-      p->state.bHatsEx1 = value;
-      break;
-    case 3:
-      p->state.bHatsEx2 = value;
-      break;
-    case 4:
-      p->state.bHatsEx3 = value;
-      break;
+  if (hat < 1 || hat > 4) {
+    return this;
   }
+  p->report.hats[hat - 1] = v == Hat::CENTER ? uint32_t(-1) : v;
   return this;
 }
 
+std::span<uint32_t, 4> VJoyDevice::getButtonWords() {
+  return p->report.buttons;
+}
+
 void VJoyDevice::flush() {
-  UpdateVJD(p->id, &p->state);
+  p->backend->write(p->report);
 }
 
 }// namespace fredemmott::inputmapping
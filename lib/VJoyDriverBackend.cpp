@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/MappableVJoyOutput.h>
+#include <cpp-remapper/VJoyDevice.h>
+
+#include <cstdio>
+#include <cstring>
+
+// clang-format off
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+// vjoy:
+#include <public.h>
+#include <vjoyinterface.h>
+// clang-format on
+
+namespace fredemmott::inputmapping {
+namespace {
+bool vjoy_initialized = false;
+
+void init_vjoy() {
+  if (vjoy_initialized) {
+    return;
+  }
+  vjoy_initialized = true;
+
+  if (!vJoyEnabled()) {
+    printf("vJoy is not enabled.\n");
+    return;
+  }
+  WORD VerDll, VerDrv;
+  if (!DriverMatch(&VerDll, &VerDrv)) {
+    printf(
+      "---\n"
+      "!!! WARNING !!!\n"
+      "vJoy driver version %04x does not match DLL version %04x\n"
+      "---\n",
+      VerDrv,
+      VerDll);
+  }
+}
+
+class VJoyDriverBackend final : public VJoyDevice::Backend {
+ public:
+  VJoyDriverBackend(uint8_t id) : mID(id) {
+    init_vjoy();
+    AcquireVJD(id);
+    // Just in case the state struct has been extended...
+    ResetVJD(id);
+
+    // ... but we also need to manually initialize our state struct
+    // as we call UpdateVJD() rather than SetAxis/SetButton
+    memset(&mState, 0, sizeof(mState));
+    mState.bDevice = id;
+  }
+
+  ~VJoyDriverBackend() {
+    RelinquishVJD(mID);
+  }
+
+  virtual void write(const VJoyDevice::Report& report) override {
+    mState.wAxisX = report.x;
+    mState.wAxisY = report.y;
+    mState.wAxisZ = report.z;
+    mState.wAxisXRot = report.rx;
+    mState.wAxisYRot = report.ry;
+    mState.wAxisZRot = report.rz;
+    mState.wSlider = report.slider;
+    mState.wDial = report.dial;
+
+    mState.lButtons = report.buttons[0];
+    mState.lButtonsEx1 = report.buttons[1];
+    mState.lButtonsEx2 = report.buttons[2];
+    mState.lButtonsEx3 = report.buttons[3];
+
+    mState.bHats = report.hats[0];
+    mState.bHatsEx1 = report.hats[1];
+    mState.bHatsEx2 = report.hats[2];
+    mState.bHatsEx3 = report.hats[3];
+
+    UpdateVJD(mID, &mState);
+  }
+
+ private:
+  BYTE mID;
+#if USE_JOYSTICK_API_VERSION == 3
+  JOYSTICK_POSITION_V3 mState;
+#elif USE_JOYSTICK_API_VERSION == 2
+  JOYSTICK_POSITION_V2 mState;
+#endif
+};
+}// namespace
+
+std::shared_ptr<VJoyDevice::Backend> VJoyDevice::createDriverBackend(
+  uint8_t id) {
+  return std::make_shared<VJoyDriverBackend>(id);
+}
+
+VJoyDevice::VJoyDevice(uint8_t id) : VJoyDevice(createDriverBackend(id)) {
+}
+
+MappableVJoyOutput::MappableVJoyOutput(uint8_t vjoy_id)
+  : MappableVJoyOutput(std::make_shared<VJoyDevice>(vjoy_id)) {
+}
+
+}// namespace fredemmott::inputmapping
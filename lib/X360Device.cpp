@@ -5,58 +5,36 @@
  * This source code is licensed under the ISC license found in the LICENSE file
  * in the root directory of this source tree.
  */
+#include <cpp-remapper/OutputConversions.h>
 #include <cpp-remapper/X360Device.h>
 
-#include <iostream>
-
-#include <cpp-remapper/ViGEmClient.h>
-#include <cpp-remapper/ViGEmTarget.h>
+// The ViGEm backend is in X360DriverBackend.cpp; this file does not depend
+// on ViGEm.
 
 namespace fredemmott::inputmapping {
 
-class X360Device::Impl final
-  : public detail::ViGEmTarget<XUSB_REPORT, X360Device::Impl> {
+class X360Device::Impl final {
  public:
-  static void initState(XUSB_REPORT* state) {
-    XUSB_REPORT_INIT(state);
-  }
-
-  static PVIGEM_TARGET allocTarget() {
-    return vigem_target_x360_alloc();
-  }
-
-  static const char* productShortName() {
-    return "X360 pad";
-  }
+  std::shared_ptr<Backend> backend;
+  Report state;
 };
 
-X360Device::X360Device() : p(new Impl()) {
-  if (p) {
-    std::cout << "Attached ViGEm X360 pad." << std::endl;
-    return;
-  }
-
-  std::cerr << "---\nERROR\n---\nFailed to initialize ViGEm X360 pad."
-            << std::endl;
-  exit(1);
+X360Device::X360Device(const std::shared_ptr<Backend>& backend)
+  : p(new Impl {backend, {}}) {
 }
 
 X360Device::~X360Device() {
 }
 
 void X360Device::flush() {
-  auto& client = ViGEmClient::get();
-  if (!client) {
-    return;
-  }
-  vigem_target_x360_update(client, p->pad, p->state);
+  p->backend->write(p->state);
 }
 
 X360Device* X360Device::setButton(Button button, bool value) {
   if (value) {
-    p->state.wButtons |= static_cast<USHORT>(button);
+    p->state.wButtons |= static_cast<uint16_t>(button);
   } else {
-    p->state.wButtons &= ~static_cast<USHORT>(button);
+    p->state.wButtons &= ~static_cast<uint16_t>(button);
   }
   return this;
 }
@@ -79,11 +57,11 @@ X360Device* X360Device::setRYAxis(long value) {
 }
 
 X360Device* X360Device::setLTrigger(long value) {
-  p->state.bLeftTrigger = (value * 255) / 65535;
+  p->state.bLeftTrigger = to_uint8_axis(value);
   return this;
 }
 X360Device* X360Device::setRTrigger(long value) {
-  p->state.bRightTrigger = (value * 255) / 65535;
+  p->state.bRightTrigger = to_uint8_axis(value);
   return this;
 }
 
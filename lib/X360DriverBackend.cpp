@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#include <cpp-remapper/ViGEmClient.h>
+#include <cpp-remapper/ViGEmTarget.h>
+#include <cpp-remapper/X360Device.h>
+
+#include <iostream>
+
+namespace fredemmott::inputmapping {
+
+namespace {
+#define CHECK_BUTTON(ours, theirs) \
+  static_assert(static_cast<USHORT>(X360Device::Button::ours) == theirs);
+CHECK_BUTTON(DPAD_UP, XUSB_GAMEPAD_DPAD_UP)
+CHECK_BUTTON(DPAD_DOWN, XUSB_GAMEPAD_DPAD_DOWN)
+CHECK_BUTTON(DPAD_LEFT, XUSB_GAMEPAD_DPAD_LEFT)
+CHECK_BUTTON(DPAD_RIGHT, XUSB_GAMEPAD_DPAD_RIGHT)
+CHECK_BUTTON(START, XUSB_GAMEPAD_START)
+CHECK_BUTTON(BACK, XUSB_GAMEPAD_BACK)
+CHECK_BUTTON(LEFT_STICK, XUSB_GAMEPAD_LEFT_THUMB)
+CHECK_BUTTON(RIGHT_STICK, XUSB_GAMEPAD_RIGHT_THUMB)
+CHECK_BUTTON(LEFT_SHOULDER, XUSB_GAMEPAD_LEFT_SHOULDER)
+CHECK_BUTTON(RIGHT_SHOULDER, XUSB_GAMEPAD_RIGHT_SHOULDER)
+CHECK_BUTTON(GUIDE, XUSB_GAMEPAD_GUIDE)
+CHECK_BUTTON(A, XUSB_GAMEPAD_A)
+CHECK_BUTTON(B, XUSB_GAMEPAD_B)
+CHECK_BUTTON(X, XUSB_GAMEPAD_X)
+CHECK_BUTTON(Y, XUSB_GAMEPAD_Y)
+#undef CHECK_BUTTON
+
+class X360DriverBackend final
+  : public X360Device::Backend,
+    public detail::ViGEmTarget<X360DriverBackend> {
+ public:
+  static PVIGEM_TARGET allocTarget() {
+    return vigem_target_x360_alloc();
+  }
+
+  static const char* productShortName() {
+    return "X360 pad";
+  }
+
+  virtual void write(const X360Device::Report& report) override {
+    auto& client = ViGEmClient::get();
+    if (!client) {
+      return;
+    }
+    const XUSB_REPORT native {
+      .wButtons = report.wButtons,
+      .bLeftTrigger = report.bLeftTrigger,
+      .bRightTrigger = report.bRightTrigger,
+      .sThumbLX = report.sThumbLX,
+      .sThumbLY = report.sThumbLY,
+      .sThumbRX = report.sThumbRX,
+      .sThumbRY = report.sThumbRY,
+    };
+    vigem_target_x360_update(client, pad, native);
+  }
+};
+}// namespace
+
+std::shared_ptr<X360Device::Backend> X360Device::createDriverBackend() {
+  return std::make_shared<X360DriverBackend>();
+}
+
+X360Device::X360Device() : X360Device(createDriverBackend()) {
+  std::cout << "Attached ViGEm X360 pad." << std::endl;
+}
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/OutputBackend.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+namespace fredemmott::inputmapping {
+
+/** Passes reports to another backend from a dedicated writer thread.
+ *
+ * `write()` just stores the report and returns, so a slow device (e.g. a
+ * FAVHID Arduino over serial) doesn't stall the event loop. If the writer
+ * thread is still busy, only the latest report is kept.
+ *
+ * Each instance has its own writer thread; FAVHID devices share a single
+ * Arduino, so their driver backend serializes writes between threads.
+ *
+ * For example:
+ *
+ *   auto vjoy = std::make_shared<VJoyDevice>(
+ *     std::make_shared<AsyncOutputBackend<VJoyDevice::Report>>(
+ *       VJoyDevice::createDriverBackend(1)));
+ */
+template <typename TReport>
+class AsyncOutputBackend final : public OutputBackend<TReport> {
+ public:
+  using Inner = OutputBackend<TReport>;
+  using clock = std::chrono::steady_clock;
+
+  struct Metrics {
+    /// Reports passed to the inner backend
+    uint64_t writes = 0;
+    /// Reports that were replaced by a newer one before they were written
+    uint64_t superseded = 0;
+    /** Latency is from the oldest unwritten `write()` call until the inner
+     * backend returns.
+     */
+    clock::duration lastLatency {};
+    clock::duration maxLatency {};
+    clock::duration totalLatency {};
+
+    clock::duration getMeanLatency() const {
+      if (!writes) {
+        return {};
+      }
+      return totalLatency / static_cast<clock::rep>(writes);
+    }
+  };
+
+  explicit AsyncOutputBackend(const std::shared_ptr<Inner>& inner)
+    : mInner(inner),
+      mThread([this](std::stop_token stop) { this->run(stop); }) {
+  }
+
+  /// Writes any pending report, then stops the writer thread
+  ~AsyncOutputBackend() {
+    mThread.request_stop();
+    mThread.join();
+  }
+
+  AsyncOutputBackend(const AsyncOutputBackend&) = delete;
+  AsyncOutputBackend& operator=(const AsyncOutputBackend&) = delete;
+
+  virtual void write(const TReport& report) override {
+    {
+      std::scoped_lock lock(mMutex);
+      if (mHavePending) {
+        ++mMetrics.superseded;
+      } else {
+        mPublishedAt = clock::now();
+        mHavePending = true;
+      }
+      mPending = report;
+    }
+    mWake.notify_one();
+  }
+
+  Metrics getMetrics() const {
+    std::scoped_lock lock(mMutex);
+    return mMetrics;
+  }
+
+ private:
+  std::shared_ptr<Inner> mInner;
+
+  mutable std::mutex mMutex;
+  std::condition_variable_any mWake;
+  // Everything below is protected by mMutex
+  TReport mPending {};
+  bool mHavePending = false;
+  clock::time_point mPublishedAt {};
+  Metrics mMetrics {};
+
+  // Last so that it's stopped before anything it uses is destroyed
+  std::jthread mThread;
+
+  void run(std::stop_token stop) {
+    // Double-buffered: the event loop only ever touches mPending, and we
+    // write from our own copy without holding the lock
+    TReport report {};
+    while (true) {
+      clock::time_point publishedAt;
+      {
+        std::unique_lock lock(mMutex);
+        if (!mWake.wait(lock, stop, [this] { return mHavePending; })) {
+          return;
+        }
+        report = mPending;
+        publishedAt = mPublishedAt;
+        mHavePending = false;
+      }
+
+      if (mInner) {
+        mInner->write(report);
+      }
+      const auto latency = clock::now() - publishedAt;
+
+      std::scoped_lock lock(mMutex);
+      ++mMetrics.writes;
+      mMetrics.lastLatency = latency;
+      mMetrics.totalLatency += latency;
+      if (latency > mMetrics.maxLatency) {
+        mMetrics.maxLatency = latency;
+      }
+    }
+  }
+};
+
+}// namespace fredemmott::inputmapping
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <cstdint>
+
 #include <cpp-remapper/Sink.h>
 #include <cpp-remapper/Source.h>
 
@@ -20,6 +22,9 @@ namespace fredemmott::inputmapping {
  * - You probably want curvature between 0 and 1; 0.5 is a good starting point.
  *   This makes the axis less sensitive near center, more sensitive when fully
  *   deflective. A negative curviness gives you the opposite.
+ *
+ * Curviness between -0.9999 and 0.9999 is evaluated with integer maths;
+ * anything more extreme uses floating point.
  */
 class AxisCurve final : public AxisSource, public AxisSink {
  public:
@@ -29,6 +34,12 @@ class AxisCurve final : public AxisSource, public AxisSink {
 
  private:
   double mCurviness;
+  // 2.30 fixed-point curviness; only valid if mFixedPoint is true
+  int64_t mFixedCurviness;
+  bool mFixedPoint;
+
+  void mapFixedPoint(long value);
+  void mapFloatingPoint(long value);
 };
 
 }// namespace fredemmott::inputmapping
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <cpp-remapper/SinkPtr.h>
+#include <cpp-remapper/SourcePtr.h>
+
+namespace fredemmott::inputmapping {
+
+/** Combines several axes into one or more new axes.
+ *
+ * Each output is `offset + sum(coefficient * input)`, limited to between
+ * `min` and `max`; for example, a rudder from toe brakes:
+ *
+ *   AxisMixer mixer({
+ *     {.coefficients = {-0.5, 0.5}, .offset = Axis::MID},
+ *   });
+ *   pedals.XAxis >> mixer.Inputs[0];// left brake
+ *   pedals.YAxis >> mixer.Inputs[1];// right brake
+ *   mixer.Outputs[0] >> vj.RZAxis;
+ *
+ * Inputs start centered. Outputs are recalculated together, once per poll,
+ * however many of the inputs changed; only outputs with a new value are
+ * updated.
+ *
+ * Every output must have one coefficient for every input, and coefficients
+ * must be between -32767 and 32767; otherwise, the constructor throws
+ * `std::invalid_argument`.
+ */
+class AxisMixer final {
+ public:
+  struct Output {
+    std::vector<double> coefficients;
+    Axis::Value offset = 0;
+    Axis::Value min = Axis::MIN;
+    Axis::Value max = Axis::MAX;
+  };
+
+ private:
+  struct State;
+  // Shared with the inputs and outputs
+  std::shared_ptr<State> p;
+
+ public:
+  AxisMixer(const std::vector<Output>& outputs);
+  ~AxisMixer();
+
+  std::vector<AxisSinkPtr> Inputs;
+  std::vector<AxisSourcePtr> Outputs;
+};
+
+}// namespace fredemmott::inputmapping
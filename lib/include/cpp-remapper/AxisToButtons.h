@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <cmath>
 #include <cstdint>
 #include <vector>
 
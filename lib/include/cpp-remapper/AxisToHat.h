@@ -21,23 +21,36 @@ namespace fredemmott::inputmapping {
  * test app - use "Monitor vJoy" instead.
  */
 class AxisToHat final : public HatSource {
+ private:
+  class AxisInput final : public Sink<Axis> {
+   public:
+    AxisInput(AxisToHat* parent, Axis::Value AxisToHat::*value);
+    virtual void map(Axis::Value value) override;
+
+   private:
+    AxisToHat* mParent;
+    Axis::Value AxisToHat::*mValue;
+  };
+
+  AxisInput mXInput {this, &AxisToHat::mX};
+  AxisInput mYInput {this, &AxisToHat::mY};
+
  public:
   static const Percent DEFAULT_DEADZONE;
 
-  AxisSinkPtr XAxis = [this](Axis::Value x) {
-    mX = x;
-    update();
-  };
-  AxisSinkPtr YAxis = [this](Axis::Value y) {
-    mY = y;
-    update();
-  };
+  AxisSinkPtr XAxis {static_cast<Sink<Axis>*>(&mXInput)};
+  AxisSinkPtr YAxis {static_cast<Sink<Axis>*>(&mYInput)};
 
   AxisToHat(Percent deadzone_percent = DEFAULT_DEADZONE);
+  // `XAxis` and `YAxis` always refer to this object, not the copied one
+  AxisToHat(const AxisToHat& other);
+  AxisToHat& operator=(const AxisToHat& other);
   ~AxisToHat();
 
  private:
   Percent mDeadzone = DEFAULT_DEADZONE;
+  // Squared distance from the center; anything closer is centered
+  int64_t mMinSquaredDistance;
   Axis::Value mX = Axis::MID;
   Axis::Value mY = Axis::MID;
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/SinkPtr.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace fredemmott::inputmapping {
+
+/** Sinks for 128 buttons stored as contiguous bits, e.g. in a vJoy report.
+ *
+ * Each sink sets or clears its bit directly. All the sinks are in the bank,
+ * so the whole bank is a single allocation.
+ */
+class ButtonBank final {
+ public:
+  using Word = uint32_t;
+  static constexpr size_t SIZE = 128;
+  static constexpr size_t WORDS = SIZE / (8 * sizeof(Word));
+
+  /// `owner` keeps `words` alive
+  ButtonBank(const std::shared_ptr<void>& owner, std::span<Word, WORDS> words)
+    : mOwner(owner) {
+    for (size_t i = 0; i < SIZE; ++i) {
+      mSinks[i] = BitSink(&words[i / (8 * sizeof(Word))], i);
+    }
+  }
+
+  /// 1-based, like the `ButtonN` members of outputs
+  static ButtonSinkPtr get(
+    const std::shared_ptr<ButtonBank>& bank,
+    uint8_t id) {
+    if (id == 0 || id > SIZE) {
+      return [](Button::Value) {};
+    }
+    // Aliasing constructor: keeps the bank alive without another allocation
+    return std::shared_ptr<Sink<Button>>(bank, &bank->mSinks[id - 1]);
+  }
+
+ private:
+  class BitSink final : public Sink<Button> {
+   public:
+    BitSink() = default;
+    BitSink(Word* word, size_t index)
+      : mWord(word), mMask(Word {1} << (index % (8 * sizeof(Word)))) {
+    }
+
+    virtual void map(Button::Value value) override {
+      if (value) {
+        *mWord |= mMask;
+      } else {
+        *mWord &= ~mMask;
+      }
+    }
+
+   private:
+    Word* mWord = nullptr;
+    Word mMask = 0;
+  };
+
+  std::shared_ptr<void> mOwner;
+  std::array<BitSink, SIZE> mSinks;
+};
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include <cpp-remapper/SourcePtr.h>
+
+namespace fredemmott::inputmapping {
+
+class MappableInput;
+
+/** Different actions for combinations of buttons pressed together.
+ *
+ * Buttons that are part of a chord are held back for up to `window` after
+ * the first one is pressed; if they form a chord, only the chord is pressed,
+ * otherwise they are passed on individually via `button()`. The chord is
+ * released as soon as any of its buttons are released.
+ *
+ * When more than one chord matches, the one with the most buttons wins.
+ * Every registered chord is checked with a couple of bitmask comparisons,
+ * so hundreds of chords are fine.
+ *
+ * This takes over any buttons it uses; map them via `button()` instead of
+ * directly from the input:
+ *
+ *   Chords chords(stick);
+ *   chords.chord({1, 5}) >> vj.Button10;
+ *   chords.button(1) >> vj.Button1;
+ *   chords.button(5) >> vj.Button5;
+ */
+class Chords final {
+ public:
+  Chords(
+    const MappableInput& input,
+    std::chrono::steady_clock::duration window
+    = std::chrono::milliseconds(50));
+  /// `buttons[0]` is button 1
+  Chords(
+    const std::vector<ButtonSourcePtr>& buttons,
+    std::chrono::steady_clock::duration window
+    = std::chrono::milliseconds(50));
+  ~Chords();
+
+  /// Pressed while all of the listed buttons are held together
+  ButtonSourcePtr chord(std::initializer_list<uint8_t> buttons);
+  /// Presses of `id` that aren't part of a chord
+  ButtonSourcePtr button(uint8_t id);
+
+ private:
+  std::vector<ButtonSourcePtr> mButtons;
+
+  struct State;
+  // Shared with the inputs and the timer
+  std::shared_ptr<State> p;
+
+  bool isValidButton(uint8_t id) const;
+  void attach(uint8_t id);
+};
+
+}// namespace fredemmott::inputmapping
@@ -15,6 +15,10 @@ namespace fredemmott::inputmapping {
 
 class Clock {
  public:
+  using TimerTarget = void (*)(
+    const std::chrono::steady_clock::duration& delay,
+    const std::function<void()>& handler);
+
   virtual ~Clock() = default;
   static std::shared_ptr<Clock> get();
   static void set(const std::shared_ptr<Clock>&);
@@ -27,6 +31,12 @@ class Clock {
 
  protected:
   Clock() = default;
+
+ private:
+  friend class EventLoop;
+  // Where the default `setTimer()` sends timers; set by the event loop, so
+  // that this doesn't depend on it
+  static void setTimerTarget(TimerTarget);
 };
 
 }// namespace fredemmott::inputmapping
@@ -17,10 +17,10 @@ class Control {};
 class Axis final : public Control {
  public:
   using Value = long;
-  static const Value MAX = 0xffff;
-  static const Value MIN = 0;
+  static constexpr Value MAX = 0xffff;
+  static constexpr Value MIN = 0;
   // Not called 'center' because that's misleading for sliders.
-  static const Value MID = MAX / 2;
+  static constexpr Value MID = MAX / 2;
 };
 
 class Button final : public Control {
@@ -31,18 +31,18 @@ class Button final : public Control {
 class Hat final : public Control {
  public:
   using Value = uint16_t;
-  static const Value MAX = 35999;
-  static const Value MIN = 0;
-  static const Value CENTER = 0xffff;
-
-  static const Value NORTH = 0;
-  static const Value NORTH_EAST = 4500;
-  static const Value EAST = 9000;
-  static const Value SOUTH_EAST = 13500;
-  static const Value SOUTH = 18000;
-  static const Value SOUTH_WEST = 22500;
-  static const Value WEST = 27000;
-  static const Value NORTH_WEST = 31500;
+  static constexpr Value MAX = 35999;
+  static constexpr Value MIN = 0;
+  static constexpr Value CENTER = 0xffff;
+
+  static constexpr Value NORTH = 0;
+  static constexpr Value NORTH_EAST = 4500;
+  static constexpr Value EAST = 9000;
+  static constexpr Value SOUTH_EAST = 13500;
+  static constexpr Value SOUTH = 18000;
+  static constexpr Value SOUTH_WEST = 22500;
+  static constexpr Value WEST = 27000;
+  static constexpr Value NORTH_WEST = 31500;
 };
 
 template <class T>
@@ -7,22 +7,37 @@
  */
 #pragma once
 
+#include <cpp-remapper/OutputBackend.h>
 #include <cpp-remapper/OutputDevice.h>
 
 #include <cstdint>
 #include <memory>
 
-// clang-format off
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#include <ViGEm/Client.h>
-// clang-format on
-
 namespace fredemmott::inputmapping {
 
 class DS4Device final : public OutputDevice {
  public:
+  /// Same fields and meaning as ViGEm's `DS4_REPORT`
+  struct Report {
+    uint8_t bThumbLX = 0x80;
+    uint8_t bThumbLY = 0x80;
+    uint8_t bThumbRX = 0x80;
+    uint8_t bThumbRY = 0x80;
+    // The low 4 bits are the D-Pad direction; starts as `DPadDirection::NONE`
+    uint16_t wButtons = 0x8;
+    uint8_t bSpecial = 0;
+    uint8_t bTriggerL = 0;
+    uint8_t bTriggerR = 0;
+
+    bool operator==(const Report&) const = default;
+  };
+  using Backend = OutputBackend<Report>;
+
+  /// Use a ViGEm virtual controller
   DS4Device();
+  /// e.g. to wrap in an `AsyncOutputBackend`
+  static std::shared_ptr<Backend> createDriverBackend();
+  explicit DS4Device(const std::shared_ptr<Backend>& backend);
   ~DS4Device();
 
   DS4Device(const DS4Device&) = delete;
@@ -30,36 +45,38 @@ class DS4Device final : public OutputDevice {
 
   virtual void flush() override;
 
-  enum class Button {
-    LEFT_THUMB = DS4_BUTTON_THUMB_LEFT,
-    RIGHT_THUMB = DS4_BUTTON_THUMB_RIGHT,
-    OPTIONS = DS4_BUTTON_OPTIONS,
-    SHARE = DS4_BUTTON_SHARE,
-    LEFT_TRIGGER = DS4_BUTTON_TRIGGER_LEFT,
-    RIGHT_TRIGGER = DS4_BUTTON_TRIGGER_RIGHT,
-    LEFT_SHOULDER = DS4_BUTTON_SHOULDER_LEFT,
-    RIGHT_SHOULDER = DS4_BUTTON_SHOULDER_LEFT,
-    TRIANGLE = DS4_BUTTON_TRIANGLE,
-    CIRCLE = DS4_BUTTON_CIRCLE,
-    CROSS = DS4_BUTTON_CROSS,
-    SQUARE = DS4_BUTTON_SQUARE,
+  // Values match ViGEm's `DS4_*` constants; this is checked in
+  // DS4DriverBackend.cpp
+  enum class Button : uint16_t {
+    LEFT_THUMB = 1 << 14,
+    RIGHT_THUMB = 1 << 15,
+    OPTIONS = 1 << 13,
+    SHARE = 1 << 12,
+    LEFT_TRIGGER = 1 << 10,
+    RIGHT_TRIGGER = 1 << 11,
+    LEFT_SHOULDER = 1 << 8,
+    RIGHT_SHOULDER = 1 << 9,
+    TRIANGLE = 1 << 7,
+    CIRCLE = 1 << 6,
+    CROSS = 1 << 5,
+    SQUARE = 1 << 4,
   };
 
-  enum class SpecialButton {
-    PS = DS4_SPECIAL_BUTTON_PS,
-    TOUCHPAD = DS4_SPECIAL_BUTTON_TOUCHPAD,
+  enum class SpecialButton : uint8_t {
+    PS = 1 << 0,
+    TOUCHPAD = 1 << 1,
   };
 
-  enum class DPadDirection {
-    NONE = DS4_BUTTON_DPAD_NONE,
-    NORTHWEST = DS4_BUTTON_DPAD_NORTHWEST,
-    WEST = DS4_BUTTON_DPAD_WEST,
-    SOUTHWEST = DS4_BUTTON_DPAD_SOUTHWEST,
-    SOUTH = DS4_BUTTON_DPAD_SOUTH,
-    SOUTHEAST = DS4_BUTTON_DPAD_SOUTHEAST,
-    EAST = DS4_BUTTON_DPAD_EAST,
-    NORTHEAST = DS4_BUTTON_DPAD_NORTHEAST,
-    NORTH = DS4_BUTTON_DPAD_NORTH,
+  enum class DPadDirection : uint8_t {
+    NONE = 0x8,
+    NORTHWEST = 0x7,
+    WEST = 0x6,
+    SOUTHWEST = 0x5,
+    SOUTH = 0x4,
+    SOUTHEAST = 0x3,
+    EAST = 0x2,
+    NORTHEAST = 0x1,
+    NORTH = 0x0,
   };
 
   DS4Device* setButton(Button button, bool value);
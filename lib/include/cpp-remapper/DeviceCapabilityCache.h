@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/AxisInformation.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fredemmott::inputmapping {
+
+/// The controls a device has, in DirectInput enumeration order.
+struct DeviceCapabilities {
+  uint32_t buttons = 0;
+  uint32_t hats = 0;
+  std::vector<AxisInformation> axes {};
+
+  bool operator==(const DeviceCapabilities&) const;
+};
+
+/** Remembers `DeviceCapabilities` between runs, so that devices don't need to
+ * be fully probed at startup.
+ *
+ * Entries are keyed by hardware ID and a fingerprint of cheap-to-fetch
+ * device properties; if either changes (e.g. a firmware update changes the
+ * descriptor), the entry is ignored.
+ *
+ * Unreadable or outdated files are treated as empty.
+ */
+class DeviceCapabilityCache final {
+ public:
+  DeviceCapabilityCache();
+  ~DeviceCapabilityCache();
+
+  static DeviceCapabilityCache load(std::istream&);
+  static DeviceCapabilityCache load(const std::filesystem::path&);
+  void save(std::ostream&) const;
+  void save(const std::filesystem::path&) const;
+
+  std::optional<DeviceCapabilities> get(
+    const std::string& hardwareID,
+    uint64_t fingerprint) const;
+  void set(
+    const std::string& hardwareID,
+    uint64_t fingerprint,
+    const DeviceCapabilities&);
+
+  size_t size() const;
+
+  /// FNV-1a; stable across runs and builds, unlike `std::hash`
+  static uint64_t fingerprint(
+    std::string_view data,
+    uint64_t seed = FNV_OFFSET);
+
+ private:
+  static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325;
+
+  struct Entry {
+    uint64_t fingerprint;
+    DeviceCapabilities capabilities;
+  };
+  std::unordered_map<std::string, Entry> mEntries;
+};
+
+}// namespace fredemmott::inputmapping
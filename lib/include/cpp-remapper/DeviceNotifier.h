@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/EventSource.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace fredemmott::inputmapping {
+
+/** Tells the profile when input devices are added or removed.
+ *
+ * Plugging in a single device usually produces a burst of notifications,
+ * and the device might not be usable until the burst is over; these are
+ * combined into a single callback once things have settled.
+ */
+class DeviceNotifier : public EventSource {
+ public:
+  using Callback = std::function<void()>;
+
+  virtual ~DeviceNotifier();
+
+  void setCallback(const Callback& callback);
+
+ protected:
+  DeviceNotifier();
+
+  /// Call from `poll()` when devices may have changed.
+  void notify();
+
+ private:
+  struct State {
+    Callback callback;
+    bool pending = false;
+  };
+  // Shared with the settle timer, which may outlive this object
+  std::shared_ptr<State> mState;
+};
+
+}// namespace fredemmott::inputmapping
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <variant>
 
 namespace fredemmott::inputmapping {
@@ -88,6 +89,12 @@ class DeviceSpecifier final : public DeviceSpecifierBase {
   virtual bool matches(const InputDevice& device) const override;
   virtual std::string getHumanReadable() const override;
 
+  // Call `f` with the concrete specifier, e.g. for index lookups
+  template <typename F>
+  decltype(auto) visit(F&& f) const {
+    return std::visit(std::forward<F>(f), p);
+  }
+
  private:
   Impl p;
 };
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace fredemmott::inputmapping {
+
+/** Information about the event that is currently being dispatched through
+ * the mapping graph.
+ *
+ * For example, an output can compare `getSampleTime()` with the current time
+ * in `flush()` to find out how stale its output is.
+ */
+class DispatchContext final {
+ public:
+  using time_point = std::chrono::steady_clock::time_point;
+
+  DispatchContext() = delete;
+
+  /// When the input being dispatched was sampled; this is a
+  /// default-constructed time_point if nothing is being dispatched.
+  static time_point getSampleTime() noexcept;
+  /// Whether there is a `Scope`
+  static bool isDispatching() noexcept;
+  /// Identifies the current dispatch, i.e. the outermost `Scope`; 0 if
+  /// nothing is being dispatched.
+  ///
+  /// Unlike the sample time, this is never shared by two dispatches.
+  static uint64_t getDispatchID() noexcept;
+
+  /// Run `callback` once the current input has been dispatched, but before
+  /// outputs are flushed; if nothing is being dispatched, it's run
+  /// immediately.
+  ///
+  /// This lets actions with several inputs update once per poll, even if
+  /// more than one of their inputs changed.
+  static void defer(std::function<void()> callback);
+  /// Run everything passed to `defer()` so far; called by the event loop
+  /// before flushing outputs.
+  static void runDeferred();
+
+  /// Sets the context until destroyed, then restores the previous one.
+  class Scope final {
+   public:
+    explicit Scope(time_point sampleTime) noexcept;
+    ~Scope() noexcept;
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    time_point mPrevious;
+  };
+
+  /// Calls `update` at most once per dispatch, however many times it's
+  /// requested; for example, for actions with several inputs, as they
+  /// often change in the same poll.
+  ///
+  /// Unlike a timer, the update runs before the current input has finished
+  /// being dispatched, so the owner can't have been destroyed yet.
+  class DeferredUpdate final {
+   public:
+    explicit DeferredUpdate(std::function<void()> update);
+
+    DeferredUpdate(const DeferredUpdate&) = delete;
+    DeferredUpdate& operator=(const DeferredUpdate&) = delete;
+
+    /// Calls `update` immediately if nothing is being dispatched
+    void request();
+
+   private:
+    std::function<void()> mUpdate;
+    bool mPending = false;
+  };
+};
+
+}// namespace fredemmott::inputmapping
@@ -20,8 +20,13 @@ class EventSource;
 class EventLoop final {
  public:
   void setEventSinks(const std::vector<std::shared_ptr<EventSink>>& sinks);
+  /// e.g. to wrap an output device in a `RateLimitedSink`
+  void replaceEventSink(
+    const std::shared_ptr<EventSink>& original,
+    const std::shared_ptr<EventSink>& replacement);
   void setEventSources(
     const std::vector<std::shared_ptr<EventSource>>& sources);
+  void addEventSource(const std::shared_ptr<EventSource>& source);
 
   void run();
 
@@ -32,7 +37,11 @@ class EventLoop final {
  private:
   std::vector<std::shared_ptr<EventSource>> mEventSources;
   std::vector<std::shared_ptr<EventSink>> mEventSinks;
-  std::map<void*, std::function<void()>> mInjected;
+  struct Injected {
+    std::chrono::steady_clock::time_point deadline;
+    std::function<void()> handler;
+  };
+  std::map<void*, Injected> mInjected;
 
   void flush();
 };
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <cpp-remapper/OutputBackend.h>
 #include <cpp-remapper/OutputDevice.h>
 
 #include <cstdint>
@@ -22,13 +23,57 @@ namespace fredemmott::inputmapping {
  */
 class FAVHIDDevice final : public OutputDevice {
  public:
+  using Report = FAVHID::FAVJoyState2::Report;
+  using Backend = OutputBackend<Report>;
+
+  /// Bits for `getChangedFields()`
+  enum ChangedField : uint16_t {
+    X_AXIS = 1 << 0,
+    Y_AXIS = 1 << 1,
+    Z_AXIS = 1 << 2,
+    RX_AXIS = 1 << 3,
+    RY_AXIS = 1 << 4,
+    RZ_AXIS = 1 << 5,
+    SLIDER = 1 << 6,
+    DIAL = 1 << 7,
+    BUTTONS = 1 << 8,
+    HATS = 1 << 9,
+    ALL_FIELDS = (1 << 10) - 1,
+  };
+
   FAVHIDDevice() = delete;
 
   FAVHIDDevice(uint8_t id);
+  /// e.g. to wrap in an `AsyncOutputBackend`; nullptr if `id` is invalid
+  static std::shared_ptr<Backend> createDriverBackend(uint8_t id);
+  explicit FAVHIDDevice(const std::shared_ptr<Backend>& backend);
   virtual ~FAVHIDDevice();
 
-  void set(const FAVHID::FAVJoyState2::Report&);
+  /// Replace the whole report
+  void set(const Report&);
+
+  /** Update individual controls in place.
+   *
+   * Values are in FAVHID's ranges; setting a control to its current value
+   * is not a change.
+   */
+  FAVHIDDevice* setXAxis(int16_t value);
+  FAVHIDDevice* setYAxis(int16_t value);
+  FAVHIDDevice* setZAxis(int16_t value);
+  FAVHIDDevice* setRXAxis(int16_t value);
+  FAVHIDDevice* setRYAxis(int16_t value);
+  FAVHIDDevice* setRZAxis(int16_t value);
+  FAVHIDDevice* setSlider(int16_t value);
+  FAVHIDDevice* setDial(int16_t value);
+  /// 1-based, like the other output devices
+  FAVHIDDevice* setButton(uint8_t button, bool value);
+  /// 1-based; `value` is a FAVHID POV value, e.g. 0b1111 for centered
+  FAVHIDDevice* setHat(uint8_t hat, int8_t value);
+
+  /// What has changed since the last `flush()`; 0 if nothing has
+  uint16_t getChangedFields() const;
 
+  /// Does nothing if nothing has changed since the last `flush()`
   virtual void flush() override;
 
  private:
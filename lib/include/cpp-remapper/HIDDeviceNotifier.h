@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/DeviceNotifier.h>
+
+#include <memory>
+
+namespace fredemmott::inputmapping {
+
+/// Notifies when HID devices are plugged in or removed
+class HIDDeviceNotifier final : public DeviceNotifier {
+ public:
+  HIDDeviceNotifier();
+  virtual ~HIDDeviceNotifier();
+
+  virtual HANDLE getHandle() override;
+  virtual void poll() override;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> p;
+};
+
+}// namespace fredemmott::inputmapping
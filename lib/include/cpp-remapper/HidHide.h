@@ -21,20 +21,32 @@
 
 namespace fredemmott::inputmapping {
 class InputDevice;
+class InputDeviceCollection;
 
 class HidHide {
  public:
   using ControlDevice = winrt::file_handle;
   using AbsoluteDosDevicePath = std::wstring;
 
-  HidHide(const std::vector<DeviceSpecifier>& devices);
+  HidHide(
+    const InputDeviceCollection& collection,
+    const std::vector<DeviceSpecifier>& devices);
 
   ~HidHide();
 
+  /// Hide any matching devices that have been plugged in since
+  void update(const InputDeviceCollection& collection);
+
  private:
   bool mInitialized = false;
+  std::vector<DeviceSpecifier> mSpecifiers;
+  std::set<std::wstring> mHiddenInstances;
+
+  void init(
+    const InputDeviceCollection& collection,
+    const std::vector<DeviceSpecifier>& devices);
 
-  void init(const std::vector<DeviceSpecifier>& devices);
+  void hideDevices(const InputDeviceCollection& collection);
 
   static ControlDevice getControlDevice();
 
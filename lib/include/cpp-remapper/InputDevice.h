@@ -19,6 +19,7 @@
 namespace fredemmott::inputmapping {
 
 struct AxisInformation;
+struct DeviceCapabilities;
 
 class InputDevice final {
  public:
@@ -28,14 +29,29 @@ class InputDevice final {
   void operator=(const InputDevice&) = delete;
   ~InputDevice();
 
+  // Stable for the same device across reconnections
+  const GUID& getInstanceGUID() const;
+  // False if the device can't be used any more, e.g. because it was
+  // unplugged, even if it has since been plugged back in
+  bool reacquire();
+
   std::string getInstanceName() const;
   std::string getProductName() const;
   std::optional<VIDPID> getVIDPID() const;
   InstanceID getInstanceID() const;
   HardwareID getHardwareID() const;
 
+  // Changes if the device's descriptor is likely to have changed
+  uint64_t getCapabilityFingerprint() const;
+  const DeviceCapabilities& getCapabilities();
+  // Skip probing, e.g. because the capabilities were cached. Must be called
+  // before the device is used.
+  void setCapabilities(const DeviceCapabilities&);
+  // Always queries the device; thread-safe.
+  std::optional<DeviceCapabilities> probeCapabilities() const;
+
   uint32_t getAxisCount();
-  std::vector<AxisInformation> getAxisInformation();
+  const std::vector<AxisInformation>& getAxisInformation();
   uint32_t getButtonCount();
   uint32_t getHatCount();
 
@@ -70,6 +86,7 @@ class InputDevice final {
   HANDLE mEventHandle = nullptr;
   bool mActivated = false;
   size_t mDataSize = 0;
+  std::vector<std::byte> mLastState;
   StateOffsets mOffsets {};
   void activate();
 };
@@ -7,10 +7,17 @@
  */
 #pragma once
 
+#include <cpp-remapper/DeviceCapabilityCache.h>
 #include <cpp-remapper/DeviceSpecifier.h>
 #include <dinput.h>
 
+#include <cstdint>
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace fredemmott::inputmapping {
@@ -22,11 +29,42 @@ class InputDeviceCollection {
   InputDeviceCollection();
   ~InputDeviceCollection();
 
-  std::shared_ptr<InputDevice> get(const DeviceSpecifier& device);
-  std::vector<std::shared_ptr<InputDevice>> getAllDevices();
+  std::shared_ptr<InputDevice> get(const DeviceSpecifier& device) const;
+  std::vector<std::shared_ptr<InputDevice>> getAllDevices() const;
+
+  struct Changes {
+    std::vector<std::shared_ptr<InputDevice>> added;
+    std::vector<std::shared_ptr<InputDevice>> removed;
+  };
+  /** Update the collection to match the devices that are currently attached.
+   *
+   * Devices that are still attached keep their existing `InputDevice`; only
+   * new devices are probed.
+   */
+  Changes rescan();
 
  private:
   std::vector<std::shared_ptr<InputDevice>> mDevices;
+
+  // Rebuilt whenever the devices change; if several devices share an
+  // identifier, the first one enumerated wins.
+  std::unordered_map<uint32_t, std::shared_ptr<InputDevice>> mByVIDPID;
+  std::unordered_map<std::string, std::shared_ptr<InputDevice>> mByHardwareID;
+  std::unordered_map<std::string, std::shared_ptr<InputDevice>> mByInstanceID;
+
+  std::filesystem::path mCachePath;
+  // Also used by the background validation
+  std::mutex mCacheMutex;
+  DeviceCapabilityCache mCache;
+  // Checks cached capabilities against the devices
+  std::vector<std::future<void>> mValidations;
+
+  struct ProbeResult {
+    std::vector<std::shared_ptr<InputDevice>> devices;
+    size_t cached = 0;
+  };
+  ProbeResult probe(const std::vector<DIDEVICEINSTANCE>&);
+  void updateIndexes();
 };
 
 }// namespace fredemmott::inputmapping
@@ -12,6 +12,7 @@
 #include <cpp-remapper/SourcePtr.h>
 
 #include <cstdint>
+#include <span>
 
 namespace fredemmott::inputmapping {
 
@@ -29,6 +30,16 @@ class MappableInput final {
 
   std::shared_ptr<EventSource> getEventSource() const;
 
+  std::shared_ptr<InputDevice> getDevice() const;
+  /** Switch to a new `InputDevice` for the same physical device, e.g. after
+   * it has been unplugged and plugged back in.
+   *
+   * Everything attached to this input stays attached; the device must have
+   * the same controls as before. Returns false if it doesn't, and the
+   * original device is kept.
+   */
+  bool setDevice(const std::shared_ptr<InputDevice>& device);
+
   AxisSourcePtr axis(uint8_t id) const;
   ButtonSourcePtr button(uint8_t id) const;
   HatSourcePtr hat(uint8_t id) const;
@@ -39,6 +50,11 @@ class MappableInput final {
   size_t getButtonCount() const;
   size_t getHatCount() const;
 
+  // Current values, in device order; useful for snapshots and diagnostics
+  std::span<const Axis::Value> getAxisValues() const;
+  std::span<const Button::Value> getButtonValues() const;
+  std::span<const Hat::Value> getHatValues() const;
+
   AxisSourcePtr XAxis, YAxis, ZAxis, RXAxis, RYAxis, RZAxis, Slider, Dial;
 
   // `seq 1 128 | gsed 's/.\+/Button\0,/' | xargs -n 4 echo` :)
@@ -14,11 +14,14 @@
 
 namespace fredemmott::inputmapping {
 
+class ButtonBank;
 class VJoyDevice;
 
 class MappableVJoyOutput final : public MappableOutput {
  private:
   std::shared_ptr<VJoyDevice> mDevice;
+  // Must be initialized before the const members
+  std::shared_ptr<ButtonBank> mButtons;
 
  public:
   MappableVJoyOutput() = delete;
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <cpp-remapper/SinkPtr.h>
+
+namespace fredemmott::inputmapping {
+
+/** Different actions for single, double, triple (and so on) taps.
+ *
+ * `handlers[0]` receives single taps, `handlers[1]` double taps, etc; any
+ * of them can be left empty (`{}`). The tap count is final once the button
+ * has been left alone for `window`: the matching handler is then pressed,
+ * and released shortly after. If the button is still held at that point,
+ * the handler is held until the button is released instead.
+ *
+ * If there is no handler for any higher tap count, the gesture finishes as
+ * soon as the button is pressed, without waiting.
+ */
+class MultiTap final : public ButtonSink {
+ public:
+  enum class SingleTap {
+    /// Wait to see if it's the start of a multi-tap
+    DELAYED,
+    /// Pass the first press of every gesture straight through to
+    /// `handlers[0]`, even if it turns out to be the start of a multi-tap
+    IMMEDIATE,
+  };
+
+  MultiTap(
+    const std::vector<ButtonSinkPtr>& handlers,
+    std::chrono::steady_clock::duration window
+    = std::chrono::milliseconds(250),
+    SingleTap singleTap = SingleTap::DELAYED);
+  ~MultiTap();
+
+  virtual void map(Button::Value value) override;
+
+ private:
+  struct State;
+  // Shared with the timer, which may outlive this object
+  std::shared_ptr<State> p;
+};
+
+}// namespace fredemmott::inputmapping
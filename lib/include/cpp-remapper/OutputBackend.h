@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+namespace fredemmott::inputmapping {
+
+/** Where an `OutputDevice` sends its reports when flushed.
+ *
+ * Output devices build a complete report for their device type; the backend
+ * is just responsible for getting it to the driver (or elsewhere - see
+ * `RecordingOutputBackend`).
+ */
+template <typename TReport>
+class OutputBackend {
+ public:
+  using Report = TReport;
+
+  virtual ~OutputBackend() = default;
+  virtual void write(const TReport& report) = 0;
+};
+
+}// namespace fredemmott::inputmapping
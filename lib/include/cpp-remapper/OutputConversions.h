@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/Controls.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace fredemmott::inputmapping {
+
+/* Conversions from our control values to each output device's format.
+ *
+ * The `compute_*` functions are the definitions; the `to_*` functions look
+ * up the same values in tables that are generated from them at compile time
+ * in OutputConversions.cpp, avoiding a division for every axis update.
+ */
+
+/// Axis::MIN..MAX to vJoy's 1..0x8000
+constexpr uint16_t compute_vjoy_axis(Axis::Value value) {
+  return ((value * (0x8000 - 1)) / Axis::MAX) + 1;
+}
+
+/// Axis::MIN..MAX to 0..255, for ViGEm triggers and DS4 sticks
+constexpr uint8_t compute_uint8_axis(Axis::Value value) {
+  return (value * 255) / Axis::MAX;
+}
+
+/// Axis::MIN..MAX to -32768..32767, for FAVHID
+constexpr int16_t compute_favhid_axis(Axis::Value value) {
+  using limits = std::numeric_limits<int16_t>;
+  constexpr int64_t inputRange = Axis::MAX - Axis::MIN;
+  constexpr int64_t outputRange = int64_t {limits::max()} - limits::min();
+  return ((int64_t {value - Axis::MIN} * outputRange) / inputRange)
+    + limits::min();
+}
+
+/// Centidegrees to a FAVHID POV: 0-7 clockwise from north, 0b1111 centered
+constexpr int8_t compute_favhid_hat(Hat::Value value) {
+  if (value > Hat::MAX) {
+    return 0b1111;
+  }
+  return value / 4500;
+}
+
+namespace detail {
+// Every possible 16-bit input value
+template <typename T>
+using ConversionTable = std::array<T, 0x10000>;
+
+extern const ConversionTable<uint16_t> VJOY_AXIS_TABLE;
+extern const ConversionTable<uint8_t> UINT8_AXIS_TABLE;
+extern const ConversionTable<int16_t> FAVHID_AXIS_TABLE;
+extern const ConversionTable<int8_t> FAVHID_HAT_TABLE;
+
+inline size_t axis_table_index(Axis::Value value) {
+  return static_cast<size_t>(std::clamp(value, Axis::MIN, Axis::MAX));
+}
+}// namespace detail
+
+inline uint16_t to_vjoy_axis(Axis::Value value) {
+  return detail::VJOY_AXIS_TABLE[detail::axis_table_index(value)];
+}
+
+inline uint8_t to_uint8_axis(Axis::Value value) {
+  return detail::UINT8_AXIS_TABLE[detail::axis_table_index(value)];
+}
+
+inline int16_t to_favhid_axis(Axis::Value value) {
+  return detail::FAVHID_AXIS_TABLE[detail::axis_table_index(value)];
+}
+
+inline int8_t to_favhid_hat(Hat::Value value) {
+  return detail::FAVHID_HAT_TABLE[value];
+}
+
+}// namespace fredemmott::inputmapping
@@ -90,6 +90,9 @@ class Profile final {
   void operator=(const Profile&) = delete;
 
   std::shared_ptr<EventLoop> getEventLoop() const;
+  InputDeviceCollection* getInputDevices() const;
+  // Reconnect `input` if its device is unplugged and plugged back in
+  void trackInput(const DeviceSpecifier& specifier, const MappableInput& input);
   void run();
 
  private:
@@ -101,7 +104,8 @@ class Profile final {
 namespace detail {
 std::tuple<> get_devices(Profile*, InputDeviceCollection*);
 
-MappableInput get_device(InputDeviceCollection*, const DeviceSpecifier&);
+MappableInput
+get_device(Profile*, InputDeviceCollection*, const DeviceSpecifier&);
 
 template <typename... Ts>
 auto get_devices(
@@ -109,7 +113,7 @@ auto get_devices(
   InputDeviceCollection* c,
   const DeviceSpecifier& first,
   Ts... rest) {
-  auto device = get_device(c, first);
+  auto device = get_device(p, c, first);
   return std::tuple_cat(std::make_tuple(device), get_devices(p, c, rest...));
 }
 
@@ -119,7 +123,7 @@ auto get_devices(
   InputDeviceCollection* c,
   const DeviceWithVisibility& first,
   Ts... rest) {
-  auto device = get_device(c, first.getSpecifier());
+  auto device = get_device(p, c, first.getSpecifier());
   return std::tuple_cat(std::make_tuple(device), get_devices(p, c, rest...));
 }
 
@@ -214,8 +218,7 @@ auto create_profile(Ts... specifiers) {
 
   auto p = Profile(input_ids);
 
-  InputDeviceCollection device_collection;
-  auto devices = detail::get_devices(&p, &device_collection, specifiers...);
+  auto devices = detail::get_devices(&p, p.getInputDevices(), specifiers...);
   // Lambda needed as the thing we're calling is a template: std::apply needs
   // an `std::function`, and we can't take a reference to a template function
   auto event_loop = p.getEventLoop();
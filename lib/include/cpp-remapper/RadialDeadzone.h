@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+
+#include <cpp-remapper/Percent.h>
+#include <cpp-remapper/SinkPtr.h>
+#include <cpp-remapper/SourcePtr.h>
+
+namespace fredemmott::inputmapping {
+
+/** A circular deadzone and curve for a pair of axes, e.g. a thumbstick.
+ *
+ * Unlike applying `SquareDeadzone` and `AxisCurve` to each axis, this
+ * operates on the distance from center, so the response is the same in
+ * every direction:
+ *
+ * - anything within `deadzone` of center is centered
+ * - further deflections are rescaled to start from center, then `curviness`
+ *   is applied to the distance as with `AxisCurve`
+ * - outside of a full single-axis deflection - i.e. in the corners of a
+ *   square gate - positions are passed through unchanged
+ *
+ * When both axes change in the same poll, the outputs are only updated once.
+ *
+ *   RadialDeadzone stick(10_percent, 0.5);
+ *   device.XAxis >> stick.XAxis;
+ *   device.YAxis >> stick.YAxis;
+ *   stick.XOutput >> vjoy1.XAxis;
+ *   stick.YOutput >> vjoy1.YAxis;
+ */
+class RadialDeadzone {
+ private:
+  struct State;
+  // Shared with the inputs and outputs
+  std::shared_ptr<State> p;
+
+ public:
+  RadialDeadzone(Percent deadzone, double curviness = 0);
+  ~RadialDeadzone();
+
+  AxisSinkPtr XAxis;
+  AxisSinkPtr YAxis;
+  AxisSourcePtr XOutput;
+  AxisSourcePtr YOutput;
+};
+
+/// A `RadialDeadzone` without a deadzone
+class RadialCurve final : public RadialDeadzone {
+ public:
+  RadialCurve(double curviness);
+};
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/EventSink.h>
+#include <cpp-remapper/SinkPtr.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace fredemmott::inputmapping {
+
+/** Limits how often another sink (usually an output device) is flushed.
+ *
+ * Flushes that come too soon after the previous one are skipped; as devices
+ * send their latest state, skipped changes are included in the next flush.
+ * If any were skipped, a trailing flush is scheduled for when the interval
+ * has passed, so the final state is always sent.
+ *
+ * Use in place of the device in the event loop's sinks:
+ *
+ *   auto limited = std::make_shared<RateLimitedSink>(
+ *     favhid.getDevice(), std::chrono::milliseconds(4));
+ *   p.getEventLoop()->replaceEventSink(favhid.getDevice(), limited);
+ *   button >> limited->prioritize(favhid.Button1);
+ */
+class RateLimitedSink final : public EventSink {
+ public:
+  struct Stats {
+    /// Flushes passed on to the next sink
+    uint64_t flushes = 0;
+    /// Flushes that were skipped, and merged into a later flush
+    uint64_t coalesced = 0;
+    /// How many of `flushes` were scheduled trailing flushes
+    uint64_t trailing = 0;
+    /// How many of `flushes` ignored the limit because of `prioritize()`
+    uint64_t prioritized = 0;
+  };
+
+  RateLimitedSink(
+    const std::shared_ptr<EventSink>& next,
+    std::chrono::steady_clock::duration minInterval);
+  ~RateLimitedSink();
+
+  virtual void flush() override;
+
+  /// Button changes via the returned sink are flushed immediately
+  ButtonSinkPtr prioritize(const ButtonSinkPtr& next);
+
+  Stats getStats() const;
+
+ private:
+  struct State;
+  // Shared with the trailing flush timer, which may outlive this object
+  std::shared_ptr<State> p;
+};
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/Clock.h>
+#include <cpp-remapper/OutputBackend.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace fredemmott::inputmapping {
+
+/** Keeps the most recent reports in memory instead of sending them anywhere.
+ *
+ * This is useful for tests and benchmarks; storage is allocated up front,
+ * so `write()` does not allocate. Once full, the oldest reports are
+ * overwritten.
+ */
+template <typename TReport>
+class RecordingOutputBackend final : public OutputBackend<TReport> {
+ public:
+  struct Record {
+    std::chrono::steady_clock::time_point when {};
+    TReport report {};
+  };
+
+  explicit RecordingOutputBackend(size_t capacity) : mRecords(capacity) {
+  }
+
+  virtual void write(const TReport& report) override {
+    if (mRecords.empty()) {
+      ++mWriteCount;
+      return;
+    }
+    auto& record = mRecords[mWriteCount % mRecords.size()];
+    record.when = Clock::get()->now();
+    record.report = report;
+    ++mWriteCount;
+  }
+
+  size_t capacity() const {
+    return mRecords.size();
+  }
+
+  /// How many reports are currently stored
+  size_t size() const {
+    return mWriteCount < mRecords.size() ? mWriteCount : mRecords.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /// How many reports have been written, including any that were overwritten
+  uint64_t getWriteCount() const {
+    return mWriteCount;
+  }
+
+  /// 0 is the oldest stored report
+  const Record& operator[](size_t i) const {
+    return mRecords[(mWriteCount - size() + i) % mRecords.size()];
+  }
+
+  const Record& back() const {
+    return (*this)[size() - 1];
+  }
+
+  void clear() {
+    mWriteCount = 0;
+  }
+
+ private:
+  std::vector<Record> mRecords;
+  uint64_t mWriteCount = 0;
+};
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <initializer_list>
+#include <memory>
+
+#include <cpp-remapper/SinkPtr.h>
+
+namespace fredemmott::inputmapping {
+
+/** Play a series of outputs, with fixed delays, when a button is pressed.
+ *
+ * Steps run one after another:
+ *
+ *   stick.Button1 >> Sequence {
+ *     Sequence::press(vj.Button3, 40ms),
+ *     Sequence::wait(20ms),
+ *     Sequence::hat(vj.Hat1, Hat::NORTH, 60ms),
+ *   };
+ *
+ * Presses of the trigger are ignored while the sequence is playing.
+ */
+class Sequence final : public ButtonSink {
+ public:
+  using duration = std::chrono::steady_clock::duration;
+
+  class Step final {
+   private:
+    friend class Sequence;
+    enum class Kind { WAIT, PRESS, AXIS, HAT };
+
+    Kind kind = Kind::WAIT;
+    duration length {};
+    ButtonSinkPtr button;
+    AxisSinkPtr axis;
+    HatSinkPtr hat;
+    long value = 0;
+  };
+
+  /// Press a button, and release it after `length`
+  static Step press(const ButtonSinkPtr& button, duration length);
+  /// Move a hat, and center it after `length`
+  static Step hat(const HatSinkPtr& hat, Hat::Value value, duration length);
+  /// Move an axis; it stays there until another step moves it
+  static Step axis(const AxisSinkPtr& axis, Axis::Value value);
+  static Step wait(duration length);
+
+  Sequence(std::initializer_list<Step> steps);
+  ~Sequence();
+
+  /// Start playing on press
+  virtual void map(Button::Value pressed) override;
+
+  bool isPlaying() const;
+  /// Stop playing, releasing any buttons or hats that are held
+  void cancel();
+
+ private:
+  struct State;
+  // Shared with the timer, which may outlive this object
+  std::shared_ptr<State> p;
+};
+
+}// namespace fredemmott::inputmapping
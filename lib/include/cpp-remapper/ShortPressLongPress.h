@@ -8,6 +8,8 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <memory>
 
 #include <cpp-remapper/SinkPtr.h>
 
@@ -16,19 +18,40 @@ namespace fredemmott::inputmapping {
 /// Different actions for if a button is short-pressed or long-pressed
 class ShortPressLongPress : public ButtonSink {
  public:
+  enum class LongPressMode {
+    /// Press and release the long-press action when the button is released
+    ON_RELEASE,
+    /// Press the long-press action as soon as the duration has passed, and
+    /// release it shortly after
+    AT_THRESHOLD,
+    /// Press the long-press action as soon as the duration has passed, and
+    /// hold it until the button is released
+    AT_THRESHOLD_UNTIL_RELEASE,
+  };
+
   ShortPressLongPress(
     ButtonSinkPtr short_handler,
     ButtonSinkPtr long_handle,
     const std::chrono::steady_clock::duration duration
-    = std::chrono::milliseconds(300));
+    = std::chrono::milliseconds(300),
+    LongPressMode mode = LongPressMode::ON_RELEASE);
   virtual void map(Button::Value state) override;
 
  private:
   ButtonSinkPtr mShortPress;
   ButtonSinkPtr mLongPress;
   std::chrono::steady_clock::duration mLongDuration;
+  LongPressMode mMode;
 
   std::chrono::time_point<std::chrono::steady_clock> mStart;
+
+  // Shared with the threshold timer, which can't be cancelled
+  struct State {
+    // Incremented on every press and release, to invalidate older timers
+    uint64_t generation = 0;
+    bool longPressed = false;
+  };
+  std::shared_ptr<State> mState;
 };
 
 }// namespace fredemmott::inputmapping
@@ -52,6 +52,14 @@ class Source : public AnySource {
   Out mValue;
 };
 
+/// A `Source` that anything can emit from; for example, for the outputs of
+/// actions that have several.
+template <std::derived_from<Control> TControl>
+class OutputSource final : public Source<TControl> {
+ public:
+  using Source<TControl>::emit;
+};
+
 using AxisSource = Source<Axis>;
 using ButtonSource = Source<Button>;
 using HatSource = Source<Hat>;
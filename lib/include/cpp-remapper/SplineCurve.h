@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include <cpp-remapper/Sink.h>
+#include <cpp-remapper/Source.h>
+
+namespace fredemmott::inputmapping {
+
+/** An arbitrary response curve, defined by control points.
+ *
+ * The curve goes through every point, with a monotone cubic spline between
+ * them, so it never overshoots; inputs before the first point or after the
+ * last are treated as that point.
+ *
+ * - there must be at least two points
+ * - inputs must be in increasing order
+ * - outputs must either never decrease, or never increase
+ *
+ * Otherwise, the constructor throws `std::invalid_argument`.
+ *
+ * The curve is turned into a table when constructed, so each event is a
+ * single lookup; curves with the same points share a table.
+ *
+ *   // Less sensitive near center, full range at the ends
+ *   stick.XAxis >> SplineCurve {
+ *     {Axis::MIN, Axis::MIN},
+ *     {0x5000, 0x6800},
+ *     {Axis::MID, Axis::MID},
+ *     {0xafff, 0x97ff},
+ *     {Axis::MAX, Axis::MAX},
+ *   } >> vj.XAxis;
+ */
+class SplineCurve final : public AxisSource, public AxisSink {
+ public:
+  struct Point {
+    Axis::Value in;
+    Axis::Value out;
+
+    auto operator<=>(const Point&) const = default;
+  };
+
+  SplineCurve(std::initializer_list<Point> points);
+  SplineCurve(const std::vector<Point>& points);
+  virtual ~SplineCurve();
+
+  virtual void map(Axis::Value value) override;
+
+  /// How many distinct tables are in use by all `SplineCurve`s
+  static size_t getTableCount();
+
+ private:
+  // Output for every possible input
+  std::shared_ptr<const std::array<uint16_t, Axis::MAX + 1>> mTable;
+};
+
+}// namespace fredemmott::inputmapping
@@ -38,7 +38,12 @@ class SquareDeadzone : public AxisSink, public AxisSource {
   virtual void map(Axis::Value value) override;
 
  private:
-  uint8_t mPercent;
+  // Exclusive bounds of the deadzone, in input units
+  Axis::Value mDeadzoneMin;
+  Axis::Value mDeadzoneMax;
+  // 32.32 fixed-point; see the constructor
+  uint64_t mScale;
+  uint64_t mOffset;
 };
 
 }// namespace fredemmott::inputmapping
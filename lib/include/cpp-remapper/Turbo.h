@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include <cpp-remapper/Sink.h>
+#include <cpp-remapper/Source.h>
+
+namespace fredemmott::inputmapping {
+
+/** Repeatedly press and release a button while it is held (autofire).
+ *
+ * Each cycle lasts `period`, and the output is pressed for `dutyCycle` of
+ * it, starting as soon as the button is pressed. Cycles are timed from the
+ * initial press rather than from when the previous timer ran, so late
+ * timers don't push back the rest of the cycles.
+ *
+ * `period` must be positive; otherwise, the constructor throws
+ * `std::invalid_argument`.
+ */
+class Turbo final : public Sink<Button>, public Source<Button> {
+ public:
+  explicit Turbo(
+    std::chrono::steady_clock::duration period,
+    float dutyCycle = 0.5f);
+  ~Turbo();
+
+  virtual void map(Button::Value pressed) override;
+  virtual void setNext(const maybe_shared_ptr<Sink<Button>>& next) override;
+
+ private:
+  struct State;
+  // Shared with the timer, which may outlive this object
+  std::shared_ptr<State> p;
+};
+
+}// namespace fredemmott::inputmapping
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cpp-remapper/OutputDevice.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace fredemmott::inputmapping {
+
+/** A virtual joystick created via Linux's `/dev/uinput`.
+ *
+ * This has the same controls as `VJoyDevice`: 8 axes, 128 buttons, and
+ * 4 hats. Each `flush()` sends everything that changed since the previous
+ * `flush()` as a single `write()`, ending with a `SYN_REPORT`.
+ */
+class UInputDevice final : public OutputDevice {
+ public:
+  static constexpr uint8_t BUTTON_COUNT = 128;
+  static constexpr uint8_t HAT_COUNT = 4;
+
+  explicit UInputDevice(const std::string& name = "cpp-remapper");
+  /** Write events to an existing file descriptor, e.g. a pipe.
+   *
+   * The fd is not set up as a uinput device, and is not closed.
+   */
+  explicit UInputDevice(int fd);
+  ~UInputDevice();
+
+  UInputDevice(const UInputDevice&) = delete;
+  UInputDevice& operator=(const UInputDevice&) = delete;
+
+  virtual void flush() override;
+
+  UInputDevice* setXAxis(long value);
+  UInputDevice* setYAxis(long value);
+  UInputDevice* setZAxis(long value);
+  UInputDevice* setRXAxis(long value);
+  UInputDevice* setRYAxis(long value);
+  UInputDevice* setRZAxis(long value);
+  UInputDevice* setSlider(long value);
+  UInputDevice* setDial(long value);
+
+  UInputDevice* setButton(uint8_t button, bool value);
+  UInputDevice* setHat(uint8_t hat, uint16_t value);
+
+  /// The `EV_KEY` code used for a button, from 1 to `BUTTON_COUNT`
+  static uint16_t getButtonCode(uint8_t button);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> p;
+};
+
+}// namespace fredemmott::inputmapping
@@ -7,16 +7,35 @@
  */
 #pragma once
 
+#include <cpp-remapper/OutputBackend.h>
 #include <cpp-remapper/OutputDevice.h>
 
 #include <cstdint>
 #include <memory>
+#include <span>
 
 namespace fredemmott::inputmapping {
 
 class VJoyDevice final : public OutputDevice {
  public:
+  /// Device state, already converted to vJoy's ranges
+  struct Report {
+    // 1 to 0x8000
+    long x = 0, y = 0, z = 0, rx = 0, ry = 0, rz = 0, slider = 0, dial = 0;
+    // Bit n of buttons[i] is button (32 * i) + n + 1
+    uint32_t buttons[4] {};
+    // Centidegrees, or 0xffffffff if centered
+    uint32_t hats[4] {};
+
+    bool operator==(const Report&) const = default;
+  };
+  using Backend = OutputBackend<Report>;
+
+  /// Use the vJoy driver
   VJoyDevice(uint8_t id);
+  /// e.g. to wrap in an `AsyncOutputBackend`
+  static std::shared_ptr<Backend> createDriverBackend(uint8_t id);
+  explicit VJoyDevice(const std::shared_ptr<Backend>& backend);
   ~VJoyDevice();
 
   virtual void flush() override;
@@ -33,6 +52,9 @@ class VJoyDevice final : public OutputDevice {
   VJoyDevice* setButton(uint8_t button, bool value);
   VJoyDevice* setHat(uint8_t hat, uint16_t value);
 
+  /// `Report::buttons`, for sinks that set bits directly, e.g. `ButtonBank`
+  std::span<uint32_t, 4> getButtonWords();
+
  private:
   struct Impl;
   std::unique_ptr<Impl> p;
@@ -10,18 +10,14 @@
 #include <concepts>
 #include <iostream>
 
-#include <cpp-remapper/DS4Device.h>
-
 namespace fredemmott::inputmapping::detail {
 
-template <typename TState, typename TDerived>
+template <typename TDerived>
 class ViGEmTarget {
  public:
-  TState state;
   PVIGEM_TARGET pad = nullptr;
 
   ViGEmTarget() {
-    TDerived::initState(&state);
     auto& client = ViGEmClient::get();
     if (!client) {
       return;
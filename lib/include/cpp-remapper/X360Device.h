@@ -7,22 +7,35 @@
  */
 #pragma once
 
+#include <cpp-remapper/OutputBackend.h>
 #include <cpp-remapper/OutputDevice.h>
 
 #include <cstdint>
 #include <memory>
 
-// clang-format off
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#include <ViGEm/Client.h>
-// clang-format on
-
 namespace fredemmott::inputmapping {
 
 class X360Device final : public OutputDevice {
  public:
+  /// Same fields and meaning as ViGEm's `XUSB_REPORT`
+  struct Report {
+    uint16_t wButtons = 0;
+    uint8_t bLeftTrigger = 0;
+    uint8_t bRightTrigger = 0;
+    int16_t sThumbLX = 0;
+    int16_t sThumbLY = 0;
+    int16_t sThumbRX = 0;
+    int16_t sThumbRY = 0;
+
+    bool operator==(const Report&) const = default;
+  };
+  using Backend = OutputBackend<Report>;
+
+  /// Use a ViGEm virtual controller
   X360Device();
+  /// e.g. to wrap in an `AsyncOutputBackend`
+  static std::shared_ptr<Backend> createDriverBackend();
+  explicit X360Device(const std::shared_ptr<Backend>& backend);
   ~X360Device();
 
   X360Device(const X360Device&) = delete;
@@ -30,22 +43,23 @@ class X360Device final : public OutputDevice {
 
   virtual void flush() override;
 
-  enum class Button {
-    DPAD_UP = XUSB_GAMEPAD_DPAD_UP,
-    DPAD_DOWN = XUSB_GAMEPAD_DPAD_DOWN,
-    DPAD_LEFT = XUSB_GAMEPAD_DPAD_LEFT,
-    DPAD_RIGHT = XUSB_GAMEPAD_DPAD_RIGHT,
-    START = XUSB_GAMEPAD_START,
-    BACK = XUSB_GAMEPAD_BACK,
-    LEFT_STICK = XUSB_GAMEPAD_LEFT_THUMB,
-    RIGHT_STICK = XUSB_GAMEPAD_RIGHT_THUMB,
-    LEFT_SHOULDER = XUSB_GAMEPAD_LEFT_SHOULDER,
-    RIGHT_SHOULDER = XUSB_GAMEPAD_RIGHT_SHOULDER,
-    GUIDE = XUSB_GAMEPAD_GUIDE,
-    A = XUSB_GAMEPAD_A,
-    B = XUSB_GAMEPAD_B,
-    X = XUSB_GAMEPAD_X,
-    Y = XUSB_GAMEPAD_Y
+  // Values are `XUSB_GAMEPAD_*`; this is checked in X360DriverBackend.cpp
+  enum class Button : uint16_t {
+    DPAD_UP = 0x0001,
+    DPAD_DOWN = 0x0002,
+    DPAD_LEFT = 0x0004,
+    DPAD_RIGHT = 0x0008,
+    START = 0x0010,
+    BACK = 0x0020,
+    LEFT_STICK = 0x0040,
+    RIGHT_STICK = 0x0080,
+    LEFT_SHOULDER = 0x0100,
+    RIGHT_SHOULDER = 0x0200,
+    GUIDE = 0x0400,
+    A = 0x1000,
+    B = 0x2000,
+    X = 0x4000,
+    Y = 0x8000
   };
 
   X360Device* setButton(Button button, bool value);
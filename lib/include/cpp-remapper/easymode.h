@@ -9,19 +9,26 @@
 
 #include <cpp-remapper/AnyOfButton.h>
 #include <cpp-remapper/AxisCurve.h>
+#include <cpp-remapper/AxisMixer.h>
 #include <cpp-remapper/AxisToButtons.h>
 #include <cpp-remapper/AxisToHat.h>
 #include <cpp-remapper/AxisTrimmer.h>
 #include <cpp-remapper/ButtonToAxis.h>
+#include <cpp-remapper/Chords.h>
 #include <cpp-remapper/CompositeSink.h>
 #include <cpp-remapper/EventLoop.h>
 #include <cpp-remapper/HatToButtons.h>
 #include <cpp-remapper/LatchedToMomentaryButton.h>
 #include <cpp-remapper/MomentaryToLatchedButton.h>
+#include <cpp-remapper/MultiTap.h>
 #include <cpp-remapper/Profile.h>
+#include <cpp-remapper/RadialDeadzone.h>
+#include <cpp-remapper/Sequence.h>
 #include <cpp-remapper/Shift.h>
 #include <cpp-remapper/ShortPressLongPress.h>
+#include <cpp-remapper/SplineCurve.h>
 #include <cpp-remapper/SquareDeadzone.h>
+#include <cpp-remapper/Turbo.h>
 #include <cpp-remapper/connections.h>
 #include <cpp-remapper/devicedb.h>
 
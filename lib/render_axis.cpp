@@ -8,6 +8,7 @@
 
 #include <cpp-remapper/render_axis.h>
 
+#include <cstring>
 #include <fstream>
 
 #include <cpp-remapper/connections.h>
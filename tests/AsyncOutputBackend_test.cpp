@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/AsyncOutputBackend.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+
+/// Blocks in `write()` until `open()` is called
+class GatedBackend final : public OutputBackend<int> {
+ public:
+  virtual void write(const int& report) override {
+    std::unique_lock lock(mMutex);
+    ++mEntered;
+    mChanged.notify_all();
+    mChanged.wait(lock, [this] { return mOpen; });
+    mReports.push_back(report);
+    mChanged.notify_all();
+  }
+
+  void open() {
+    std::scoped_lock lock(mMutex);
+    mOpen = true;
+    mChanged.notify_all();
+  }
+
+  void waitForEntered(size_t count) {
+    std::unique_lock lock(mMutex);
+    mChanged.wait(lock, [=, this] { return mEntered >= count; });
+  }
+
+  std::vector<int> waitForReports(size_t count) {
+    std::unique_lock lock(mMutex);
+    mChanged.wait(lock, [=, this] { return mReports.size() >= count; });
+    return mReports;
+  }
+
+ private:
+  std::mutex mMutex;
+  std::condition_variable mChanged;
+  bool mOpen = false;
+  size_t mEntered = 0;
+  std::vector<int> mReports;
+};
+
+}// namespace
+
+TEST_CASE("AsyncOutputBackend") {
+  auto inner = std::make_shared<GatedBackend>();
+  AsyncOutputBackend<int> backend(inner);
+
+  backend.write(1);
+  inner->waitForEntered(1);
+
+  // The writer thread is stuck in the inner backend, but we aren't
+  backend.write(2);
+  backend.write(3);
+  REQUIRE(backend.getMetrics().writes == 0);
+  REQUIRE(backend.getMetrics().superseded == 1);
+
+  inner->open();
+  REQUIRE(inner->waitForReports(2) == std::vector<int> {1, 3});
+
+  // Metrics are updated after the inner write returns
+  while (backend.getMetrics().writes < 2) {
+    std::this_thread::yield();
+  }
+  const auto metrics = backend.getMetrics();
+  REQUIRE(metrics.writes == 2);
+  REQUIRE(metrics.maxLatency >= metrics.lastLatency);
+  REQUIRE(metrics.totalLatency >= metrics.maxLatency);
+  REQUIRE(metrics.getMeanLatency() <= metrics.maxLatency);
+}
+
+TEST_CASE("AsyncOutputBackend writes pending reports when destroyed") {
+  auto inner = std::make_shared<GatedBackend>();
+  inner->open();
+  {
+    AsyncOutputBackend<int> backend(inner);
+    backend.write(1);
+  }
+  REQUIRE(inner->waitForReports(1) == std::vector<int> {1});
+}
@@ -8,10 +8,38 @@
 
 #include <cpp-remapper/AxisCurve.h>
 
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
 #include "tests.h"
 
 using namespace fredemmott::inputmapping;
 
+namespace {
+// The previous floating-point-only implementation
+long reference_curve(double k, long value) {
+  const auto scale = value > 0x7fff ? 0x8000 : 0x7fff;
+  const double x = (value - 0x7fff) / (double)scale;
+  const auto fx = (x - (x * k)) / (k - (std::abs(x) * 2 * k) + 1);
+  const auto clamped = fx > 1.0 ? 1.0 : (fx < -1.0 ? -1.0 : fx);
+  return static_cast<long>((clamped * scale) + 0x7fff);
+}
+
+class ReferenceCurve final : public AxisSink, public AxisSource {
+ public:
+  ReferenceCurve(double curviness) : mCurviness(curviness) {
+  }
+
+  virtual void map(Axis::Value value) override {
+    emit(reference_curve(mCurviness, value));
+  }
+
+ private:
+  double mCurviness;
+};
+}// namespace
+
 TEST_CASE("AxisCurve") {
   long out = -1;
 
@@ -51,3 +79,80 @@ TEST_CASE("AxisCurve") {
   // deflection
   REQUIRE(out < extreme_out);
 }
+
+TEST_CASE("AxisCurve matches floating point") {
+  const auto curviness = GENERATE(
+    -0.99999, -0.9999, -0.99, -0.5, -0.1, 0.0, 0.1, 0.5, 0.99, 0.9999, 0.99999);
+  CAPTURE(curviness);
+
+  long out = -1;
+  TestAxis axis;
+  axis >> AxisCurve {curviness} >> &out;
+
+  long worst = 0;
+  for (long value = 0; value <= 0xffff; ++value) {
+    axis.emit(value);
+    worst = std::max(worst, std::abs(out - reference_curve(curviness, value)));
+  }
+  REQUIRE(worst <= 1);
+}
+
+TEST_CASE("AxisCurve out of range values") {
+  const auto curviness = GENERATE(-0.99, -0.5, 0.0, 0.5, 0.99);
+  CAPTURE(curviness);
+
+  long out = -1;
+  TestAxis axis;
+  axis >> AxisCurve {curviness} >> &out;
+
+  axis.emit(0x10000);
+  REQUIRE(out == Axis::MAX);
+  axis.emit(0x13fff);
+  REQUIRE(out == Axis::MAX);
+  axis.emit(-1);
+  REQUIRE(out == Axis::MIN);
+  axis.emit(-0x10000);
+  REQUIRE(out == Axis::MIN);
+}
+
+TEST_CASE("AxisCurve performance", "[.][benchmark]") {
+  using clock = std::chrono::steady_clock;
+  const auto curviness = GENERATE(0.5, 0.99999);
+  const long rounds = 100;
+
+  long out;
+  TestAxis axis;
+  axis >> AxisCurve {curviness} >> &out;
+  uint64_t checksum = 0;
+  auto start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    for (long value = 0; value <= 0xffff; ++value) {
+      axis.emit(value);
+      checksum += out;
+    }
+  }
+  const auto actual = clock::now() - start;
+
+  TestAxis referenceAxis;
+  referenceAxis >> ReferenceCurve(curviness) >> &out;
+  uint64_t referenceChecksum = 0;
+  start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    for (long value = 0; value <= 0xffff; ++value) {
+      referenceAxis.emit(value);
+      referenceChecksum += out;
+    }
+  }
+  const auto floating = clock::now() - start;
+  // Allow for one LSB per event
+  const uint64_t events = rounds * 0x10000;
+  REQUIRE(checksum <= referenceChecksum + events);
+  REQUIRE(referenceChecksum <= checksum + events);
+
+  using namespace std::chrono;
+  printf(
+    "AxisCurve(%g): %.1fns/event; floating point: %.1fns/event\n",
+    curviness,
+    duration<double, std::nano>(actual).count() / events,
+    duration<double, std::nano>(floating).count() / events);
+}
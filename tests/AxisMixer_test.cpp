@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/AxisMixer.h>
+#include <cpp-remapper/DispatchContext.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("AxisMixer") {
+  TestAxis left, right;
+  Axis::Value rudder = -1, brakes = -1;
+  AxisMixer mixer({
+    {.coefficients = {-0.5, 0.5}, .offset = Axis::MID},
+    {.coefficients = {1, 1}},
+  });
+  REQUIRE(mixer.Inputs.size() == 2);
+  REQUIRE(mixer.Outputs.size() == 2);
+  left >> mixer.Inputs[0];
+  right >> mixer.Inputs[1];
+  mixer.Outputs[0] >> &rudder;
+  mixer.Outputs[1] >> &brakes;
+
+  left.emit(Axis::MIN);
+  right.emit(Axis::MIN);
+  REQUIRE(rudder == Axis::MID);
+  REQUIRE(brakes == Axis::MIN);
+
+  right.emit(Axis::MAX);
+  REQUIRE(rudder == Axis::MAX);
+  REQUIRE(brakes == Axis::MAX);
+
+  left.emit(Axis::MAX);
+  right.emit(Axis::MIN);
+  REQUIRE(rudder == Axis::MIN);
+
+  right.emit(0x4000);
+  REQUIRE(rudder == 0x2000);
+  // Clamped
+  REQUIRE(brakes == Axis::MAX);
+
+  left.emit(0x1000);
+  REQUIRE(rudder == Axis::MID + 0x1800);
+  REQUIRE(brakes == 0x5000);
+}
+
+TEST_CASE("AxisMixer ranges") {
+  TestAxis in;
+  Axis::Value out = -1;
+  AxisMixer mixer({
+    {.coefficients = {2}, .offset = -Axis::MAX, .min = 0x1000, .max = 0xe000},
+  });
+  in >> mixer.Inputs[0];
+  mixer.Outputs[0] >> &out;
+
+  in.emit(Axis::MIN);
+  REQUIRE(out == 0x1000);
+  in.emit(Axis::MID + 0x1000);
+  REQUIRE(out == 0x1fff);
+  in.emit(Axis::MAX);
+  REQUIRE(out == 0xe000);
+}
+
+TEST_CASE("AxisMixer updates once per poll") {
+  TestAxis a, b, c;
+  int firstUpdates = 0, secondUpdates = 0;
+  AxisMixer mixer({
+    {.coefficients = {0.5, 0.5, 0}},
+    {.coefficients = {0, 0, 1}},
+  });
+  a >> mixer.Inputs[0];
+  b >> mixer.Inputs[1];
+  c >> mixer.Inputs[2];
+  mixer.Outputs[0] >> [&firstUpdates](Axis::Value) { ++firstUpdates; };
+  mixer.Outputs[1] >> [&secondUpdates](Axis::Value) { ++secondUpdates; };
+
+  SECTION("Not polling") {
+    a.emit(Axis::MAX);
+    b.emit(Axis::MAX);
+    REQUIRE(firstUpdates == 2);
+    // Only the first update changes it
+    REQUIRE(secondUpdates == 1);
+  }
+
+  SECTION("Polling") {
+    {
+      DispatchContext::Scope dispatch(std::chrono::steady_clock::now());
+      a.emit(Axis::MAX);
+      b.emit(Axis::MAX);
+      c.emit(Axis::MAX);
+      REQUIRE(firstUpdates == 0);
+    }
+    REQUIRE(firstUpdates == 1);
+    REQUIRE(secondUpdates == 1);
+
+    {
+      DispatchContext::Scope dispatch(std::chrono::steady_clock::now());
+      a.emit(Axis::MIN);
+      b.emit(Axis::MIN);
+    }
+    REQUIRE(firstUpdates == 2);
+    REQUIRE(secondUpdates == 1);
+  }
+}
+
+TEST_CASE("AxisMixer validation") {
+  using Outputs = std::vector<AxisMixer::Output>;
+  REQUIRE_THROWS_AS(AxisMixer(Outputs {}), std::invalid_argument);
+  REQUIRE_THROWS_AS(
+    AxisMixer(Outputs {{.coefficients = {}}}), std::invalid_argument);
+  REQUIRE_THROWS_AS(
+    AxisMixer(Outputs {{.coefficients = {1, 0}}, {.coefficients = {1}}}),
+    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+    AxisMixer(Outputs {{.coefficients = {1}, .min = 0x8000, .max = 0x7000}}),
+    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+    AxisMixer(Outputs {{.coefficients = {1}, .min = -1}}),
+    std::invalid_argument);
+  // Coefficients must fit in 32-bit 16.16 fixed-point
+  REQUIRE_NOTHROW(AxisMixer(Outputs {{.coefficients = {-32767, 32767}}}));
+  REQUIRE_THROWS_AS(
+    AxisMixer(Outputs {{.coefficients = {32768}}}), std::invalid_argument);
+  REQUIRE_THROWS_AS(
+    AxisMixer(Outputs {{.coefficients = {std::nan("")}}}),
+    std::invalid_argument);
+}
+
+TEST_CASE("AxisMixer performance", "[.][benchmark]") {
+  using clock = std::chrono::steady_clock;
+  const long polls = 1000000;
+
+  // e.g. two throttles and two toe brakes, from different devices
+  TestAxis inputs[4];
+  Axis::Value outputs[4];
+  AxisMixer mixer({
+    {.coefficients = {0.5, 0.5, 0, 0}},
+    {.coefficients = {0, 0, -0.5, 0.5}, .offset = Axis::MID},
+    {.coefficients = {0, 0, 1, 0}},
+    {.coefficients = {0, 0, 0, 1}},
+  });
+  for (size_t i = 0; i < 4; ++i) {
+    inputs[i] >> mixer.Inputs[i];
+    mixer.Outputs[i] >> &outputs[i];
+  }
+
+  uint64_t checksum = 0;
+  const auto sampleTime = clock::now();
+  const auto start = clock::now();
+  for (long i = 0; i < polls; ++i) {
+    {
+      DispatchContext::Scope poll(sampleTime);
+      for (auto& input: inputs) {
+        input.emit((i * 7919) & Axis::MAX);
+      }
+    }
+    checksum += outputs[0] + outputs[1] + outputs[2] + outputs[3];
+  }
+  const auto elapsed = clock::now() - start;
+  REQUIRE(checksum > 0);
+
+  using namespace std::chrono;
+  printf(
+    "AxisMixer (4x4): %.1fns/poll\n",
+    duration<double, std::nano>(elapsed).count() / polls);
+}
@@ -6,12 +6,45 @@
  * in the root directory of this source tree.
  */
 
+#define _USE_MATH_DEFINES
 #include <cpp-remapper/AxisToHat.h>
 
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
 #include "tests.h"
 
 using namespace fredemmott::inputmapping;
 
+namespace {
+// The previous floating-point implementation
+Hat::Value reference_hat(Axis::Value ax, Axis::Value ay, Percent deadzone) {
+  const auto x = ax - Axis::MID;
+  const auto y = ay - Axis::MID;
+  const auto distance = sqrt((x * x) + (y * y));
+  if ((distance * 100) / Hat::CENTER < deadzone.value() / 2) {
+    return Hat::CENTER;
+  }
+  const auto radians = atan2(y, x);
+  const auto centidegrees = std::lround((18000 * radians) / M_PI) + 9000;
+  return centidegrees < 0 ? centidegrees + 36000 : centidegrees;
+}
+
+std::vector<Axis::Value> grid_values() {
+  std::vector<Axis::Value> ret {
+    Axis::MIN, Axis::MIN + 1, Axis::MAX - 1, Axis::MAX};
+  for (auto i = Axis::MID - 3; i <= Axis::MID + 3; ++i) {
+    ret.push_back(i);
+  }
+  for (Axis::Value i = 0; i < Axis::MAX; i += 251) {
+    ret.push_back(i);
+  }
+  return ret;
+}
+}// namespace
+
 TEST_CASE("AxisToHat") {
   TestAxis x, y;
   Hat::Value hat;
@@ -56,3 +89,62 @@ TEST_CASE("AxisToHat") {
   x.emit(Axis::MAX);
   REQUIRE(hat == Hat::SOUTH_EAST);
 }
+
+TEST_CASE("AxisToHat matches floating-point results") {
+  const auto deadzone = GENERATE(0_percent, 50_percent, 90_percent);
+  TestAxis x, y;
+  Hat::Value hat;
+  AxisToHat ath(deadzone);
+  x >> ath.XAxis;
+  y >> ath.YAxis;
+  ath >> &hat;
+
+  const auto values = grid_values();
+  size_t mismatches = 0;
+  for (const auto xv: values) {
+    x.emit(xv);
+    for (const auto yv: values) {
+      y.emit(yv);
+      if (hat != reference_hat(xv, yv, deadzone)) {
+        ++mismatches;
+      }
+    }
+  }
+  REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("AxisToHat performance", "[.][benchmark]") {
+  using clock = std::chrono::steady_clock;
+  const auto values = grid_values();
+  const auto events = values.size() * values.size();
+
+  Hat::Value hat;
+  AxisToHat ath;
+  ath >> &hat;
+  uint64_t checksum = 0;
+  auto start = clock::now();
+  for (const auto xv: values) {
+    ath.XAxis->map(xv);
+    for (const auto yv: values) {
+      ath.YAxis->map(yv);
+      checksum += hat;
+    }
+  }
+  const auto integer = clock::now() - start;
+
+  uint64_t referenceChecksum = 0;
+  start = clock::now();
+  for (const auto xv: values) {
+    for (const auto yv: values) {
+      referenceChecksum += reference_hat(xv, yv, AxisToHat::DEFAULT_DEADZONE);
+    }
+  }
+  const auto floating = clock::now() - start;
+  REQUIRE(checksum == referenceChecksum);
+
+  using namespace std::chrono;
+  printf(
+    "AxisToHat: %.1fns/event; floating point: %.1fns/event\n",
+    duration<double, std::nano>(integer).count() / events,
+    duration<double, std::nano>(floating).count() / events);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/ButtonBank.h>
+#include <cpp-remapper/MappableVJoyOutput.h>
+#include <cpp-remapper/RecordingOutputBackend.h>
+#include <cpp-remapper/VJoyDevice.h>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("ButtonBank") {
+  auto words = std::make_shared<std::array<uint32_t, ButtonBank::WORDS>>();
+  auto bank = std::make_shared<ButtonBank>(words, *words);
+
+  ButtonBank::get(bank, 1)->map(true);
+  ButtonBank::get(bank, 33)->map(true);
+  ButtonBank::get(bank, 128)->map(true);
+  REQUIRE((*words)[0] == 1);
+  REQUIRE((*words)[1] == 1);
+  REQUIRE((*words)[2] == 0);
+  REQUIRE((*words)[3] == uint32_t {1} << 31);
+
+  ButtonBank::get(bank, 1)->map(false);
+  REQUIRE((*words)[0] == 0);
+
+  SECTION("Sinks keep the storage alive") {
+    auto sink = ButtonBank::get(bank, 2);
+    std::weak_ptr<void> weakWords = words;
+    bank.reset();
+    words.reset();
+    REQUIRE_FALSE(weakWords.expired());
+    sink->map(true);
+  }
+
+  SECTION("Out-of-range IDs are ignored") {
+    ButtonBank::get(bank, 0)->map(true);
+    ButtonBank::get(bank, 129)->map(true);
+    REQUIRE((*words)[0] == 0);
+  }
+}
+
+TEST_CASE("MappableVJoyOutput buttons") {
+  auto backend
+    = std::make_shared<RecordingOutputBackend<VJoyDevice::Report>>(1);
+  MappableVJoyOutput output(std::make_shared<VJoyDevice>(backend));
+
+  TestButton a, b;
+  a >> output.Button1;
+  b >> output.button(100);
+  a.emit(true);
+  b.emit(true);
+  output.getDevice()->flush();
+
+  const auto& report = backend->back().report;
+  REQUIRE(report.buttons[0] == 1);
+  REQUIRE(report.buttons[3] == uint32_t {1} << 3);
+}
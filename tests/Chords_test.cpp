@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/Chords.h>
+
+#include <array>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("Chords") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  std::array<TestButton, 8> inputs;
+  std::vector<ButtonSourcePtr> sources;
+  for (auto& input: inputs) {
+    sources.push_back(ButtonSourcePtr(input));
+  }
+  const auto press = [&](uint8_t id) { inputs[id - 1].emit(true); };
+  const auto release = [&](uint8_t id) { inputs[id - 1].emit(false); };
+
+  Chords chords(sources, 50ms);
+  Button::Value b1(false), b2(false), b5(false), b8(false);
+  Button::Value c15(false), c125(false), c67(false);
+  chords.button(1) >> &b1;
+  chords.button(2) >> &b2;
+  chords.button(5) >> &b5;
+  chords.button(8) >> &b8;
+  chords.chord({1, 5}) >> &c15;
+  chords.chord({1, 2, 5}) >> &c125;
+  chords.chord({6, 7}) >> &c67;
+
+  SECTION("Buttons that aren't in chords aren't delayed") {
+    press(8);
+    REQUIRE(b8);
+    release(8);
+    REQUIRE(!b8);
+  }
+
+  SECTION("Single chord button is passed on after the window") {
+    press(1);
+    REQUIRE(!b1);
+    clock->advance(50ms);
+    REQUIRE(b1);
+    REQUIRE(!c15);
+    release(1);
+    REQUIRE(!b1);
+  }
+
+  SECTION("Tap within the window") {
+    press(5);
+    release(5);
+    REQUIRE(b5);
+    clock->advance(100ms);
+    REQUIRE(!b5);
+  }
+
+  SECTION("Chord") {
+    press(6);
+    REQUIRE(!c67);
+    press(7);
+    // Nothing bigger contains 6+7, so no need to wait
+    REQUIRE(c67);
+    clock->advance(1s);
+    REQUIRE(c67);
+    release(7);
+    REQUIRE(!c67);
+    release(6);
+    REQUIRE(!c67);
+  }
+
+  SECTION("Component buttons are suppressed") {
+    press(1);
+    press(5);
+    clock->advance(50ms);
+    REQUIRE(c15);
+    REQUIRE(!c125);
+    REQUIRE(!b1);
+    REQUIRE(!b5);
+    release(1);
+    REQUIRE(!c15);
+    REQUIRE(!b1);
+    REQUIRE(!b5);
+    release(5);
+    REQUIRE(!b5);
+  }
+
+  SECTION("Biggest chord wins") {
+    press(1);
+    press(5);
+    press(2);
+    REQUIRE(c125);
+    REQUIRE(!c15);
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+    REQUIRE(!b5);
+    release(2);
+    REQUIRE(!c125);
+  }
+
+  SECTION("Leftover buttons are passed on") {
+    press(1);
+    press(5);
+    press(8);
+    clock->advance(50ms);
+    REQUIRE(c15);
+    REQUIRE(b8);
+    press(2);
+    clock->advance(50ms);
+    REQUIRE(b2);
+    REQUIRE(!c125);
+  }
+
+  SECTION("Too slow for a chord") {
+    press(1);
+    clock->advance(50ms);
+    press(5);
+    clock->advance(50ms);
+    REQUIRE(b1);
+    REQUIRE(b5);
+    REQUIRE(!c15);
+  }
+
+  SECTION("Chords without valid buttons are ignored") {
+    Button::Value empty(false), invalid(false);
+    chords.chord({}) >> &empty;
+    chords.chord({0, 9}) >> &invalid;
+    press(1);
+    clock->advance(50ms);
+    REQUIRE(b1);
+    release(1);
+    press(6);
+    press(7);
+    REQUIRE(c67);
+    REQUIRE(!empty);
+    REQUIRE(!invalid);
+  }
+}
+
+TEST_CASE("Chords with many chords") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  std::array<TestButton, 128> inputs;
+  std::vector<ButtonSourcePtr> sources;
+  for (auto& input: inputs) {
+    sources.push_back(ButtonSourcePtr(input));
+  }
+
+  Chords chords(sources, 50ms);
+  std::vector<int> pressed;
+  for (uint8_t i = 1; i < 128; ++i) {
+    chords.chord({i, static_cast<uint8_t>(i + 1)})
+      >> [&pressed, i](Button::Value value) {
+           if (value) {
+             pressed.push_back(i);
+           }
+         };
+  }
+
+  inputs[99].emit(true);
+  inputs[100].emit(true);
+  clock->advance(50ms);
+  REQUIRE(pressed == std::vector<int> {100});
+}
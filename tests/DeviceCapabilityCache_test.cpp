@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/DeviceCapabilityCache.h>
+
+#include <sstream>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("DeviceCapabilityCache") {
+  const std::string hardwareID {"HID\\VID_231D&PID_0200"};
+  const auto fingerprint = DeviceCapabilityCache::fingerprint("Gladiator");
+  const DeviceCapabilities caps {
+    .buttons = 34,
+    .hats = 1,
+    .axes = {
+      {AxisType::X, "X Axis"},
+      {AxisType::Y, "Y Axis"},
+      {AxisType::SLIDER, "Slider"},
+    },
+  };
+
+  DeviceCapabilityCache cache;
+  cache.set(hardwareID, fingerprint, caps);
+  REQUIRE(cache.get(hardwareID, fingerprint) == caps);
+  REQUIRE(!cache.get(hardwareID, fingerprint + 1));
+  REQUIRE(!cache.get("HID\\VID_231D&PID_0201", fingerprint));
+
+  std::stringstream buffer;
+  cache.save(buffer);
+
+  SECTION("Round trip") {
+    auto loaded = DeviceCapabilityCache::load(buffer);
+    REQUIRE(loaded.size() == 1);
+    REQUIRE(loaded.get(hardwareID, fingerprint) == caps);
+  }
+
+  SECTION("Truncated") {
+    const auto bytes = buffer.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+    REQUIRE(DeviceCapabilityCache::load(truncated).size() == 0);
+  }
+
+  SECTION("Not a cache") {
+    std::stringstream garbage("this is not a capability cache");
+    REQUIRE(DeviceCapabilityCache::load(garbage).size() == 0);
+  }
+
+  SECTION("Fingerprints are stable") {
+    // FNV-1a test vectors
+    REQUIRE(DeviceCapabilityCache::fingerprint("") == 0xcbf29ce484222325);
+    REQUIRE(DeviceCapabilityCache::fingerprint("a") == 0xaf63dc4c8601ec8c);
+    const auto a = DeviceCapabilityCache::fingerprint("a");
+    REQUIRE(
+      DeviceCapabilityCache::fingerprint("b", a)
+      == DeviceCapabilityCache::fingerprint("ab"));
+  }
+}
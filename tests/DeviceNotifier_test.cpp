@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/DeviceNotifier.h>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+class FakeDeviceNotifier final : public DeviceNotifier {
+ public:
+  virtual HANDLE getHandle() override {
+    return nullptr;
+  }
+
+  virtual void poll() override {
+    notify();
+  }
+};
+}// namespace
+
+TEST_CASE("DeviceNotifier") {
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  int changes = 0;
+  auto notifier = std::make_shared<FakeDeviceNotifier>();
+  notifier->setCallback([&changes]() { ++changes; });
+
+  // Nothing happens until things settle
+  notifier->poll();
+  REQUIRE(changes == 0);
+  clock->advance(std::chrono::milliseconds(1));
+  REQUIRE(changes == 0);
+
+  SECTION("Bursts are combined") {
+    notifier->poll();
+    notifier->poll();
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(changes == 1);
+
+    notifier->poll();
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(changes == 2);
+  }
+
+  SECTION("Destroyed before settling") {
+    notifier.reset();
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(changes == 0);
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/DispatchContext.h>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("DispatchContext") {
+  using time_point = DispatchContext::time_point;
+  REQUIRE(DispatchContext::getSampleTime() == time_point {});
+
+  SECTION("Nested scopes") {
+    const auto outer = std::chrono::steady_clock::now();
+    const auto inner = outer + std::chrono::milliseconds(1);
+    {
+      DispatchContext::Scope a(outer);
+      REQUIRE(DispatchContext::getSampleTime() == outer);
+      {
+        DispatchContext::Scope b(inner);
+        REQUIRE(DispatchContext::getSampleTime() == inner);
+      }
+      REQUIRE(DispatchContext::getSampleTime() == outer);
+    }
+    REQUIRE(DispatchContext::getSampleTime() == time_point {});
+  }
+
+  SECTION("Dispatch IDs") {
+    REQUIRE(DispatchContext::getDispatchID() == 0);
+    const auto now = std::chrono::steady_clock::now();
+    uint64_t first {};
+    {
+      DispatchContext::Scope a(now);
+      first = DispatchContext::getDispatchID();
+      REQUIRE(first != 0);
+      DispatchContext::Scope b(now);
+      REQUIRE(DispatchContext::getDispatchID() == first);
+    }
+    REQUIRE(DispatchContext::getDispatchID() == 0);
+    {
+      // Same sample time, but a different dispatch
+      DispatchContext::Scope c(now);
+      REQUIRE(DispatchContext::getDispatchID() != 0);
+      REQUIRE(DispatchContext::getDispatchID() != first);
+    }
+  }
+
+  SECTION("Timers are sampled when due") {
+    auto clock = std::make_shared<FakeClock>();
+    Clock::set(clock);
+
+    const auto due = clock->now() + std::chrono::milliseconds(10);
+    time_point seen {};
+    clock->setTimer(std::chrono::milliseconds(10), [&seen]() {
+      seen = DispatchContext::getSampleTime();
+    });
+    clock->advance(std::chrono::milliseconds(15));
+    REQUIRE(seen == due);
+    REQUIRE(clock->now() > seen);
+    REQUIRE(DispatchContext::getSampleTime() == time_point {});
+  }
+
+  SECTION("Sample time flows through a pipeline") {
+    TestButton button;
+    time_point seen {};
+    button >> [&seen](Button::Value) {
+      seen = DispatchContext::getSampleTime();
+    };
+
+    const auto sampled = std::chrono::steady_clock::now();
+    DispatchContext::Scope dispatch(sampled);
+    button.emit(true);
+    REQUIRE(seen == sampled);
+  }
+
+  SECTION("Deferred work") {
+    int calls = 0;
+    DispatchContext::defer([&calls]() { ++calls; });
+    // Nothing is being dispatched
+    REQUIRE(calls == 1);
+
+    {
+      DispatchContext::Scope a(std::chrono::steady_clock::now());
+      REQUIRE(DispatchContext::isDispatching());
+      DispatchContext::defer([&calls]() {
+        ++calls;
+        DispatchContext::defer([&calls]() { ++calls; });
+      });
+      REQUIRE(calls == 1);
+      DispatchContext::runDeferred();
+      REQUIRE(calls == 3);
+
+      DispatchContext::defer([&calls]() { ++calls; });
+      {
+        DispatchContext::Scope b(std::chrono::steady_clock::now());
+      }
+      // Only the outermost scope runs deferred work
+      REQUIRE(calls == 3);
+    }
+    REQUIRE(calls == 4);
+    REQUIRE_FALSE(DispatchContext::isDispatching());
+  }
+  SECTION("Deferred updates") {
+    int calls = 0;
+    DispatchContext::DeferredUpdate update([&calls]() { ++calls; });
+    update.request();
+    // Nothing is being dispatched
+    REQUIRE(calls == 1);
+
+    {
+      DispatchContext::Scope dispatch(std::chrono::steady_clock::now());
+      update.request();
+      update.request();
+      REQUIRE(calls == 1);
+      DispatchContext::runDeferred();
+      REQUIRE(calls == 2);
+
+      // Can be requested again once it has run
+      update.request();
+    }
+    REQUIRE(calls == 3);
+  }
+}
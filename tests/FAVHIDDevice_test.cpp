@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/FAVHIDDevice.h>
+#include <cpp-remapper/MappableFAVHIDOutput.h>
+#include <cpp-remapper/RecordingOutputBackend.h>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("FAVHIDDevice") {
+  auto backend
+    = std::make_shared<RecordingOutputBackend<FAVHIDDevice::Report>>(4);
+  auto device = std::make_shared<FAVHIDDevice>(backend);
+
+  // The initial state is sent once
+  REQUIRE(device->getChangedFields() == FAVHIDDevice::ALL_FIELDS);
+  device->flush();
+  REQUIRE(backend->getWriteCount() == 1);
+  REQUIRE(device->getChangedFields() == 0);
+  device->flush();
+  REQUIRE(backend->getWriteCount() == 1);
+
+  SECTION("Changes are tracked by field") {
+    device->setXAxis(123)->setButton(3, true);
+    REQUIRE(
+      device->getChangedFields()
+      == (FAVHIDDevice::X_AXIS | FAVHIDDevice::BUTTONS));
+    device->flush();
+    REQUIRE(backend->getWriteCount() == 2);
+    REQUIRE(backend->back().report.x == 123);
+  }
+
+  SECTION("Setting the current value is not a change") {
+    device->setXAxis(0)->setButton(1, false)->setHat(1, 0);
+    REQUIRE(device->getChangedFields() == 0);
+    device->flush();
+    REQUIRE(backend->getWriteCount() == 1);
+  }
+
+  SECTION("MappableFAVHIDOutput updates the device's report") {
+    MappableFAVHIDOutput output(device);
+    TestAxis axis;
+    TestButton button;
+    axis >> output.YAxis;
+    button >> output.Button1;
+
+    axis.emit(Axis::MAX);
+    button.emit(true);
+    button.emit(false);
+    REQUIRE(
+      device->getChangedFields()
+      == (FAVHIDDevice::Y_AXIS | FAVHIDDevice::BUTTONS));
+    output.getDevice()->flush();
+    REQUIRE(backend->getWriteCount() == 2);
+    REQUIRE(backend->back().report.y == INT16_MAX);
+
+    axis.emit(Axis::MAX);
+    output.getDevice()->flush();
+    REQUIRE(backend->getWriteCount() == 2);
+  }
+}
@@ -7,6 +7,8 @@
  */
 #include "FakeClock.h"
 
+#include <cpp-remapper/DispatchContext.h>
+
 namespace fredemmott::inputmapping {
 
 FakeClock::FakeClock() {
@@ -21,11 +23,25 @@ void FakeClock::advance(const std::chrono::steady_clock::duration& amount) {
       ++it;
       continue;
     }
-    handler();
+    {
+      DispatchContext::Scope dispatch(when);
+      handler();
+      if (mAfterTimer) {
+        mAfterTimer();
+      }
+    }
     it = mTimers.erase(it);
   }
 }
 
+size_t FakeClock::getPendingTimerCount() const {
+  return mTimers.size();
+}
+
+void FakeClock::setAfterTimer(const std::function<void()>& callback) {
+  mAfterTimer = callback;
+}
+
 std::chrono::steady_clock::time_point FakeClock::now() noexcept {
   return mNow;
 }
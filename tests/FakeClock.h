@@ -15,12 +15,20 @@ namespace fredemmott::inputmapping {
 class FakeClock : public Clock {
  private:
   std::chrono::steady_clock::time_point mNow;
-  std::map<std::chrono::steady_clock::time_point, std::function<void()>> mTimers;
+  // Multiple timers can be due at the same time
+  std::multimap<std::chrono::steady_clock::time_point, std::function<void()>>
+    mTimers;
+  std::function<void()> mAfterTimer;
 
  public:
   FakeClock();
 
   void advance(const std::chrono::steady_clock::duration& amount);
+  /// Timers that haven't fired yet
+  size_t getPendingTimerCount() const;
+  /// Called after each timer in the same dispatch, e.g. to flush sinks like
+  /// the event loop does
+  void setAfterTimer(const std::function<void()>& callback);
 
   virtual std::chrono::steady_clock::time_point now() noexcept override;
 
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/MultiTap.h>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+class CountingClock final : public FakeClock {
+ public:
+  int timers = 0;
+
+  virtual void setTimer(
+    const std::chrono::steady_clock::duration& delay,
+    const std::function<void()>& handler) noexcept override {
+    ++timers;
+    FakeClock::setTimer(delay, handler);
+  }
+};
+
+void tap(TestButton& button, FakeClock& clock) {
+  using namespace std::chrono_literals;
+  button.emit(true);
+  clock.advance(50ms);
+  button.emit(false);
+  clock.advance(50ms);
+}
+}// namespace
+
+TEST_CASE("MultiTap") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<CountingClock>();
+  Clock::set(clock);
+
+  TestButton button;
+  Button::Value b1(false), b2(false), b3(false);
+
+  button >> MultiTap({&b1, &b2, &b3}, 250ms);
+
+  SECTION("Single tap") {
+    tap(button, *clock);
+    REQUIRE(!b1);
+    clock->advance(200ms);
+    REQUIRE(b1);
+    REQUIRE(!b2);
+    REQUIRE(!b3);
+    clock->advance(100ms);
+    REQUIRE(!b1);
+  }
+
+  SECTION("Double tap") {
+    tap(button, *clock);
+    tap(button, *clock);
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+    clock->advance(200ms);
+    REQUIRE(!b1);
+    REQUIRE(b2);
+    clock->advance(100ms);
+    REQUIRE(!b2);
+    clock->advance(1s);
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+
+  SECTION("Highest tap count doesn't wait") {
+    tap(button, *clock);
+    tap(button, *clock);
+    button.emit(true);
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+    REQUIRE(b3);
+    clock->advance(1s);
+    REQUIRE(b3);
+    button.emit(false);
+    REQUIRE(!b3);
+  }
+
+  SECTION("Double tap and hold") {
+    tap(button, *clock);
+    button.emit(true);
+    clock->advance(250ms);
+    REQUIRE(b2);
+    clock->advance(1s);
+    REQUIRE(b2);
+    button.emit(false);
+    REQUIRE(!b2);
+    REQUIRE(!b1);
+  }
+
+  SECTION("Separate gestures") {
+    tap(button, *clock);
+    clock->advance(1s);
+    REQUIRE(b1);
+    tap(button, *clock);
+    REQUIRE(!b1);
+    clock->advance(1s);
+    REQUIRE(b1);
+    REQUIRE(!b2);
+    clock->advance(100ms);
+    REQUIRE(!b1);
+  }
+
+  SECTION("Taps re-arm the existing timer") {
+    tap(button, *clock);
+    tap(button, *clock);
+    const auto timers = clock->timers;
+    // The first tap's timer is still pending, so nothing new was scheduled
+    REQUIRE(timers == 1);
+    clock->advance(300ms);
+    REQUIRE(b2);
+  }
+}
+
+TEST_CASE("MultiTap with missing handlers") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  TestButton button;
+  Button::Value b1(false);
+  std::vector<bool> b3Values;
+
+  button >> MultiTap(
+    {&b1, {}, [&](Button::Value value) { b3Values.push_back(value); }},
+    250ms);
+
+  SECTION("Unbound double tap does nothing") {
+    tap(button, *clock);
+    tap(button, *clock);
+    clock->advance(1s);
+    REQUIRE(!b1);
+    REQUIRE(b3Values.empty());
+  }
+
+  SECTION("Triple tap") {
+    tap(button, *clock);
+    tap(button, *clock);
+    tap(button, *clock);
+    REQUIRE(b3Values == std::vector<bool> {true, false});
+    clock->advance(1s);
+    REQUIRE(!b1);
+  }
+}
+
+TEST_CASE("MultiTap with immediate single taps") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  TestButton button;
+  Button::Value b1(false), b2(false);
+
+  button >> MultiTap({&b1, &b2}, 250ms, MultiTap::SingleTap::IMMEDIATE);
+
+  SECTION("Single tap") {
+    button.emit(true);
+    REQUIRE(b1);
+    clock->advance(1s);
+    REQUIRE(b1);
+    button.emit(false);
+    REQUIRE(!b1);
+    clock->advance(1s);
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+
+  SECTION("Double tap") {
+    button.emit(true);
+    REQUIRE(b1);
+    button.emit(false);
+    REQUIRE(!b1);
+    button.emit(true);
+    REQUIRE(!b1);
+    REQUIRE(b2);
+    button.emit(false);
+    REQUIRE(!b2);
+  }
+}
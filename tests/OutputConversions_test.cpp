@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/OutputConversions.h>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+
+// Exhaustive checks over every axis value; these are evaluated by the
+// compiler, so need the raised constexpr step limit from lib/CMakeLists.txt
+
+template <auto F>
+constexpr bool is_monotonic() {
+  auto previous = F(Axis::MIN);
+  for (Axis::Value i = Axis::MIN + 1; i <= Axis::MAX; ++i) {
+    const auto value = F(i);
+    if (value < previous) {
+      return false;
+    }
+    previous = value;
+  }
+  return true;
+}
+
+template <auto F>
+constexpr bool reaches_endpoints() {
+  using limits = std::numeric_limits<decltype(F(0))>;
+  return F(Axis::MIN) == limits::min() && F(Axis::MAX) == limits::max();
+}
+
+static_assert(compute_vjoy_axis(Axis::MIN) == 1);
+static_assert(compute_vjoy_axis(Axis::MAX) == 0x8000);
+static_assert(is_monotonic<compute_vjoy_axis>());
+
+static_assert(reaches_endpoints<compute_uint8_axis>());
+static_assert(is_monotonic<compute_uint8_axis>());
+
+static_assert(reaches_endpoints<compute_favhid_axis>());
+static_assert(is_monotonic<compute_favhid_axis>());
+
+constexpr bool favhid_hats_are_valid() {
+  for (uint32_t i = 0; i <= 0xffff; ++i) {
+    const auto value = compute_favhid_hat(static_cast<Hat::Value>(i));
+    if (i <= Hat::MAX && (value < 0 || value > 7)) {
+      return false;
+    }
+    if (i > Hat::MAX && value != 0b1111) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(favhid_hats_are_valid());
+static_assert(compute_favhid_hat(Hat::NORTH) == 0);
+static_assert(compute_favhid_hat(Hat::EAST) == 2);
+static_assert(compute_favhid_hat(Hat::NORTH_WEST) == 7);
+static_assert(compute_favhid_hat(Hat::CENTER) == 0b1111);
+
+}// namespace
+
+TEST_CASE("Output conversion tables") {
+  for (Axis::Value i = Axis::MIN; i <= Axis::MAX; ++i) {
+    // Not REQUIRE(), as that'd be a lot of assertions
+    if (
+      to_vjoy_axis(i) != compute_vjoy_axis(i)
+      || to_uint8_axis(i) != compute_uint8_axis(i)
+      || to_favhid_axis(i) != compute_favhid_axis(i)) {
+      FAIL("Mismatch for axis value " << i);
+    }
+  }
+  for (uint32_t i = 0; i <= 0xffff; ++i) {
+    const auto value = static_cast<Hat::Value>(i);
+    if (to_favhid_hat(value) != compute_favhid_hat(value)) {
+      FAIL("Mismatch for hat value " << i);
+    }
+  }
+
+  // Out-of-range values are clamped
+  REQUIRE(to_vjoy_axis(-1) == 1);
+  REQUIRE(to_vjoy_axis(Axis::MAX + 1) == 0x8000);
+  REQUIRE(to_uint8_axis(Axis::MAX * 2) == 255);
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/DispatchContext.h>
+#include <cpp-remapper/RadialDeadzone.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+// Normalizing the distance for every event, instead of using a table
+std::pair<Axis::Value, Axis::Value> reference_radial(
+  Axis::Value ax,
+  Axis::Value ay,
+  double deadzone,
+  double k) {
+  const double full = 0x8000;
+  const double dx = ax - Axis::MID;
+  const double dy = ay - Axis::MID;
+  const auto r = std::sqrt((dx * dx) + (dy * dy));
+  if (r >= full) {
+    return {ax, ay};
+  }
+  const auto dead = deadzone * full;
+  const auto t = (r - dead) / (full - dead);
+  if (t <= 0) {
+    return {Axis::MID, Axis::MID};
+  }
+  const auto ft = std::clamp((t - (t * k)) / (k - (t * 2 * k) + 1), 0.0, 1.0);
+  const auto gain = (ft * full) / r;
+  const auto axis = [gain](double d) {
+    return std::clamp<Axis::Value>(
+      std::lround(Axis::MID + (d * gain)), Axis::MIN, Axis::MAX);
+  };
+  return {axis(dx), axis(dy)};
+}
+
+// Same as RadialDeadzone's
+uint32_t double_rounded_sqrt(uint64_t n) {
+  return static_cast<uint32_t>(std::sqrt(static_cast<double>(n)) + 0.5);
+}
+
+// Branchless digit-by-digit square root, rounded to nearest
+uint32_t integer_rounded_sqrt(uint64_t wide) {
+  auto n = static_cast<uint32_t>(wide);
+  uint32_t root = 0;
+  for (uint32_t bit = uint32_t {1} << 30; bit; bit >>= 2) {
+    const auto trial = root + bit;
+    const auto mask = 0 - static_cast<uint32_t>(n >= trial);
+    n -= trial & mask;
+    root = (root >> 1) + (bit & mask);
+  }
+  // n is now the remainder; round up if it's past (root + 0.5)^2
+  return root + (n > root);
+}
+}// namespace
+
+TEST_CASE("RadialDeadzone") {
+  TestAxis x, y;
+  Axis::Value outX = -1, outY = -1;
+  RadialDeadzone stick(20_percent);
+  x >> stick.XAxis;
+  y >> stick.YAxis;
+  stick.XOutput >> &outX;
+  stick.YOutput >> &outY;
+
+  x.emit(Axis::MID);
+  REQUIRE(outX == Axis::MID);
+  REQUIRE(outY == Axis::MID);
+
+  // Within the deadzone on both axes...
+  x.emit(Axis::MID + 4000);
+  y.emit(Axis::MID + 4000);
+  REQUIRE(outX == Axis::MID);
+  REQUIRE(outY == Axis::MID);
+  // ... but not combined
+  x.emit(Axis::MID + 6000);
+  y.emit(Axis::MID + 6000);
+  REQUIRE(outX > Axis::MID);
+  REQUIRE(outY == outX);
+
+  // Full deflections along a single axis are unchanged
+  x.emit(Axis::MAX);
+  y.emit(Axis::MID);
+  REQUIRE(outX == Axis::MAX);
+  REQUIRE(outY == Axis::MID);
+  x.emit(Axis::MIN);
+  REQUIRE(outX == Axis::MIN);
+  REQUIRE(outY == Axis::MID);
+  x.emit(Axis::MID);
+  y.emit(Axis::MIN);
+  REQUIRE(outX == Axis::MID);
+  REQUIRE(outY == Axis::MIN);
+
+  // So are corners
+  x.emit(Axis::MIN);
+  REQUIRE(outX == Axis::MIN);
+  REQUIRE(outY == Axis::MIN);
+  x.emit(Axis::MAX);
+  y.emit(Axis::MAX);
+  REQUIRE(outX == Axis::MAX);
+  REQUIRE(outY == Axis::MAX);
+
+  // Direction is kept
+  x.emit(Axis::MID + 20000);
+  y.emit(Axis::MID - 10000);
+  REQUIRE(std::abs((outX - Axis::MID) + 2 * (outY - Axis::MID)) <= 2);
+
+  // Same distance, different directions
+  x.emit(Axis::MID + 20000);
+  y.emit(Axis::MID);
+  const auto straight = outX - Axis::MID;
+  x.emit(Axis::MID + 14142);
+  y.emit(Axis::MID + 14142);
+  const auto diagonal
+    = std::lround(std::hypot(outX - Axis::MID, outY - Axis::MID));
+  REQUIRE(std::abs(straight - diagonal) <= 2);
+}
+
+TEST_CASE("RadialDeadzone matches floating point") {
+  const auto deadzone = GENERATE(0, 10, 20);
+  const auto curviness = GENERATE(0.0, 0.5, -0.5);
+  CAPTURE(deadzone, curviness);
+
+  TestAxis x, y;
+  Axis::Value outX = -1, outY = -1;
+  RadialDeadzone stick(Percent(deadzone), curviness);
+  x >> stick.XAxis;
+  y >> stick.YAxis;
+  stick.XOutput >> &outX;
+  stick.YOutput >> &outY;
+
+  long worst = 0;
+  for (Axis::Value xv = Axis::MIN; xv <= Axis::MAX; xv += 257) {
+    x.emit(xv);
+    for (Axis::Value yv = Axis::MIN; yv <= Axis::MAX; yv += 127) {
+      y.emit(yv);
+      const auto [rx, ry]
+        = reference_radial(xv, yv, deadzone / 100.0, curviness);
+      worst = std::max({worst, std::abs(outX - rx), std::abs(outY - ry)});
+    }
+  }
+  // The table is indexed by whole distances from center
+  REQUIRE(worst <= 3);
+}
+
+TEST_CASE("RadialDeadzone updates once per poll") {
+  TestAxis x, y;
+  int xUpdates = 0, yUpdates = 0;
+  RadialDeadzone stick(10_percent);
+  x >> stick.XAxis;
+  y >> stick.YAxis;
+  stick.XOutput >> [&xUpdates](Axis::Value) { ++xUpdates; };
+  stick.YOutput >> [&yUpdates](Axis::Value) { ++yUpdates; };
+
+  SECTION("Not polling") {
+    x.emit(Axis::MAX);
+    y.emit(Axis::MAX);
+    REQUIRE(xUpdates == 2);
+    REQUIRE(yUpdates == 2);
+  }
+
+  SECTION("Polling") {
+    {
+      DispatchContext::Scope dispatch(std::chrono::steady_clock::now());
+      x.emit(Axis::MAX);
+      y.emit(Axis::MAX);
+      REQUIRE(xUpdates == 0);
+      DispatchContext::runDeferred();
+      REQUIRE(xUpdates == 1);
+      REQUIRE(yUpdates == 1);
+
+      x.emit(Axis::MIN);
+    }
+    // Also run when the outermost scope ends
+    REQUIRE(xUpdates == 2);
+    REQUIRE(yUpdates == 2);
+  }
+}
+
+TEST_CASE("RadialCurve") {
+  TestAxis x, y;
+  Axis::Value outX = -1, outY = -1;
+  RadialCurve stick(0.5);
+  x >> stick.XAxis;
+  y >> stick.YAxis;
+  stick.XOutput >> &outX;
+  stick.YOutput >> &outY;
+
+  // No deadzone
+  x.emit(Axis::MID + 100);
+  REQUIRE(outX > Axis::MID);
+  REQUIRE(outY == Axis::MID);
+
+  // Less sensitive near center
+  x.emit(Axis::MID + 0x4000);
+  REQUIRE(outX > Axis::MID);
+  REQUIRE(outX < Axis::MID + 0x4000);
+  y.emit(Axis::MID + 0x4000);
+  REQUIRE(outY == outX);
+
+  x.emit(Axis::MAX);
+  y.emit(Axis::MID);
+  REQUIRE(outX == Axis::MAX);
+}
+
+TEST_CASE("RadialDeadzone performance", "[.][benchmark]") {
+  using clock = std::chrono::steady_clock;
+  const long rounds = 20;
+  const Axis::Value step = 61;
+  const auto polls = rounds * (Axis::MAX / step) * (Axis::MAX / step);
+
+  TestAxis x, y;
+  Axis::Value outX, outY;
+  RadialDeadzone stick(10_percent, 0.5);
+  x >> stick.XAxis;
+  y >> stick.YAxis;
+  stick.XOutput >> &outX;
+  stick.YOutput >> &outY;
+
+  // Both axes change in every poll
+  uint64_t checksum = 0;
+  const auto sampleTime = clock::now();
+  auto start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    for (Axis::Value xv = 0; xv + step <= Axis::MAX; xv += step) {
+      for (Axis::Value yv = 0; yv + step <= Axis::MAX; yv += step) {
+        {
+          DispatchContext::Scope poll(sampleTime);
+          x.emit(xv);
+          y.emit(yv);
+        }
+        checksum += outX + outY;
+      }
+    }
+  }
+  const auto table = clock::now() - start;
+
+  uint64_t referenceChecksum = 0;
+  start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    for (Axis::Value xv = 0; xv + step <= Axis::MAX; xv += step) {
+      for (Axis::Value yv = 0; yv + step <= Axis::MAX; yv += step) {
+        const auto [rx, ry] = reference_radial(xv, yv, 0.1, 0.5);
+        referenceChecksum += rx + ry;
+      }
+    }
+  }
+  const auto floating = clock::now() - start;
+  REQUIRE(checksum > 0);
+  REQUIRE(referenceChecksum > 0);
+
+  using namespace std::chrono;
+  printf(
+    "RadialDeadzone: %.1fns/poll including dispatch; floating-point kernel "
+    "alone: %.1fns/poll\n",
+    duration<double, std::nano>(table).count() / polls,
+    duration<double, std::nano>(floating).count() / polls);
+}
+
+TEST_CASE("RadialDeadzone square root", "[.][benchmark]") {
+  using clock = std::chrono::steady_clock;
+  const long rounds = 20;
+  const int64_t step = 61;
+
+  // Each result feeds into the next input, as there's one per poll
+  const auto time = [=](auto rounded_sqrt, uint32_t& last) {
+    long count = 0;
+    const auto start = clock::now();
+    for (long i = 0; i < rounds; ++i) {
+      for (int64_t dx = -0x8000; dx < 0x8000; dx += step) {
+        for (int64_t dy = -0x8000; dy < 0x8000; dy += step) {
+          last = rounded_sqrt(((dx * dx) + (dy * dy)) | (last & 1));
+          ++count;
+        }
+      }
+    }
+    return std::chrono::duration<double, std::nano>(clock::now() - start)
+             .count()
+      / count;
+  };
+
+  uint32_t floatingLast = 0, integerLast = 0;
+  const auto floating = time(&double_rounded_sqrt, floatingLast);
+  const auto integer = time(&integer_rounded_sqrt, integerLast);
+  REQUIRE(floatingLast == integerLast);
+  REQUIRE(integer_rounded_sqrt(uint64_t {1} << 31) == 46341);
+
+  printf(
+    "RadialDeadzone rounded square root: %.1fns via double, %.1fns via "
+    "integer bit-by-bit\n",
+    floating,
+    integer);
+}
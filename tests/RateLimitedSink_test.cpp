@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/DispatchContext.h>
+#include <cpp-remapper/RateLimitedSink.h>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+class CountingSink final : public EventSink {
+ public:
+  int flushes = 0;
+  virtual void flush() override {
+    ++flushes;
+  }
+};
+}// namespace
+
+TEST_CASE("RateLimitedSink") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  auto next = std::make_shared<CountingSink>();
+  RateLimitedSink limited(next, 10ms);
+
+  limited.flush();
+  REQUIRE(next->flushes == 1);
+
+  SECTION("Flushes within the interval are coalesced") {
+    clock->advance(1ms);
+    limited.flush();
+    clock->advance(1ms);
+    limited.flush();
+    REQUIRE(next->flushes == 1);
+    REQUIRE(limited.getStats().coalesced == 2);
+
+    // Trailing flush; the event loop then flushes in the same dispatch,
+    // which is covered by the trailing flush
+    clock->setAfterTimer([&]() { limited.flush(); });
+    clock->advance(8ms);
+    REQUIRE(next->flushes == 2);
+    REQUIRE(limited.getStats().trailing == 1);
+    REQUIRE(limited.getStats().coalesced == 2);
+
+    // A later dispatch isn't, even with the same sample time
+    {
+      DispatchContext::Scope dispatch(clock->now());
+      limited.flush();
+    }
+    REQUIRE(next->flushes == 2);
+    REQUIRE(limited.getStats().coalesced == 3);
+    clock->advance(10ms);
+    REQUIRE(next->flushes == 3);
+    REQUIRE(limited.getStats().trailing == 2);
+
+    // Nothing more to send
+    clock->advance(100ms);
+    REQUIRE(next->flushes == 3);
+  }
+
+  SECTION("Flushes after the interval are immediate") {
+    clock->advance(10ms);
+    limited.flush();
+    REQUIRE(next->flushes == 2);
+    REQUIRE(limited.getStats().coalesced == 0);
+  }
+
+  SECTION("Prioritized buttons bypass the limit") {
+    bool pressed = false;
+    TestButton button;
+    button >> limited.prioritize([&pressed](bool value) { pressed = value; });
+
+    clock->advance(1ms);
+    button.emit(true);
+    REQUIRE(pressed);
+    limited.flush();
+    REQUIRE(next->flushes == 2);
+    REQUIRE(limited.getStats().prioritized == 1);
+
+    // Only the flush straight after the button change
+    clock->advance(1ms);
+    limited.flush();
+    REQUIRE(next->flushes == 2);
+    REQUIRE(limited.getStats().coalesced == 1);
+  }
+}
+
+TEST_CASE("RateLimitedSink in an event loop") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  auto next = std::make_shared<CountingSink>();
+  RateLimitedSink limited(next, 10ms);
+
+  // Like EventLoop::run(), sinks are flushed in the same dispatch as each
+  // input or timer
+  const auto dispatched = [&]() {
+    DispatchContext::runDeferred();
+    limited.flush();
+  };
+  clock->setAfterTimer(dispatched);
+  const auto input = [&]() {
+    DispatchContext::Scope dispatch(clock->now());
+    dispatched();
+  };
+
+  input();
+  REQUIRE(next->flushes == 1);
+
+  // Every burst needs its own trailing flush
+  for (int burst = 1; burst <= 3; ++burst) {
+    clock->advance(1ms);
+    input();
+    clock->advance(1ms);
+    input();
+    REQUIRE(next->flushes == burst);
+    REQUIRE(clock->getPendingTimerCount() == 1);
+
+    clock->advance(8ms);
+    REQUIRE(next->flushes == burst + 1);
+    REQUIRE(limited.getStats().trailing == burst);
+    REQUIRE(clock->getPendingTimerCount() == 0);
+  }
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/DS4Device.h>
+#include <cpp-remapper/RecordingOutputBackend.h>
+#include <cpp-remapper/VJoyDevice.h>
+#include <cpp-remapper/X360Device.h>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("RecordingOutputBackend") {
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  RecordingOutputBackend<int> backend(3);
+  REQUIRE(backend.capacity() == 3);
+  REQUIRE(backend.empty());
+
+  const auto start = clock->now();
+  for (int i = 1; i <= 5; ++i) {
+    backend.write(i);
+    clock->advance(std::chrono::milliseconds(1));
+  }
+
+  REQUIRE(backend.getWriteCount() == 5);
+  REQUIRE(backend.size() == 3);
+  REQUIRE(backend[0].report == 3);
+  REQUIRE(backend[1].report == 4);
+  REQUIRE(backend.back().report == 5);
+  REQUIRE(backend[0].when == start + std::chrono::milliseconds(2));
+  REQUIRE(backend.back().when == start + std::chrono::milliseconds(4));
+
+  backend.clear();
+  REQUIRE(backend.empty());
+  REQUIRE(backend.getWriteCount() == 0);
+}
+
+TEST_CASE("VJoyDevice reports") {
+  auto backend
+    = std::make_shared<RecordingOutputBackend<VJoyDevice::Report>>(8);
+  VJoyDevice device(backend);
+
+  device.flush();
+  REQUIRE(backend->size() == 1);
+  const auto initial = backend->back().report;
+  // Axis::MID, scaled to vJoy's 1..0x8000
+  REQUIRE(initial.x == 0x4000);
+  REQUIRE(initial.dial == 0x4000);
+  REQUIRE(initial.buttons[0] == 0);
+  REQUIRE(initial.hats[0] == 0xffffffff);
+
+  device.setButton(1, true)->setButton(33, true)->setHat(2, 9000);
+  device.setXAxis(0)->setYAxis(0xffff);
+  device.flush();
+  REQUIRE(backend->size() == 2);
+  auto report = backend->back().report;
+  REQUIRE(report.buttons[0] == 1);
+  REQUIRE(report.buttons[1] == 1);
+  REQUIRE(report.hats[0] == 0xffffffff);
+  REQUIRE(report.hats[1] == 9000);
+  REQUIRE(report.x == 1);
+  REQUIRE(report.y == 0x8000);
+
+  device.setButton(1, false)->setHat(2, Hat::CENTER);
+  device.flush();
+  report = backend->back().report;
+  REQUIRE(report.buttons[0] == 0);
+  REQUIRE(report.buttons[1] == 1);
+  REQUIRE(report.hats[1] == 0xffffffff);
+}
+
+TEST_CASE("X360Device reports") {
+  auto backend
+    = std::make_shared<RecordingOutputBackend<X360Device::Report>>(1);
+  X360Device device(backend);
+
+  device.setButton(X360Device::Button::A, true)
+    ->setLXAxis(0)
+    ->setLYAxis(0)
+    ->setRTrigger(0xffff);
+  device.flush();
+  const auto report = backend->back().report;
+  REQUIRE(report.wButtons == static_cast<uint16_t>(X360Device::Button::A));
+  REQUIRE(report.sThumbLX == -32768);
+  // Y is inverted
+  REQUIRE(report.sThumbLY == 32767);
+  REQUIRE(report.bLeftTrigger == 0);
+  REQUIRE(report.bRightTrigger == 255);
+}
+
+TEST_CASE("DS4Device reports") {
+  auto backend = std::make_shared<RecordingOutputBackend<DS4Device::Report>>(1);
+  DS4Device device(backend);
+
+  device.flush();
+  REQUIRE(backend->back().report == DS4Device::Report {});
+
+  device.setDPad(DS4Device::DPadDirection::EAST)
+    ->setButton(DS4Device::Button::CROSS, true)
+    ->setButton(DS4Device::SpecialButton::PS, true);
+  device.flush();
+  auto report = backend->back().report;
+  REQUIRE((report.wButtons & 0xf) == 0x2);
+  REQUIRE((report.wButtons & ~0xf) == (1 << 5));
+  REQUIRE(report.bSpecial == 1);
+
+  device.setDPad(DS4Device::DPadDirection::NONE);
+  device.flush();
+  report = backend->back().report;
+  REQUIRE(report.wButtons == ((1 << 5) | 0x8));
+}
+
+namespace {
+
+template <class TDevice>
+double ns_per_flush(TDevice& device, auto&& change) {
+  using clock = std::chrono::steady_clock;
+  const long rounds = 1000000;
+  const auto start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    change(device, i);
+    device.flush();
+  }
+  const auto elapsed = clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / rounds;
+}
+
+}// namespace
+
+TEST_CASE("Output device flush performance", "[.][benchmark]") {
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  auto vjoyBackend
+    = std::make_shared<RecordingOutputBackend<VJoyDevice::Report>>(1);
+  VJoyDevice vjoy(vjoyBackend);
+  const auto vjoyNs = ns_per_flush(vjoy, [](auto& device, long i) {
+    device.setXAxis(i & 0xffff)->setButton(1 + (i % 128), i & 1);
+  });
+
+  auto x360Backend
+    = std::make_shared<RecordingOutputBackend<X360Device::Report>>(1);
+  X360Device x360(x360Backend);
+  const auto x360Ns = ns_per_flush(x360, [](auto& device, long i) {
+    device.setLXAxis(i & 0xffff)->setButton(X360Device::Button::A, i & 1);
+  });
+
+  auto ds4Backend
+    = std::make_shared<RecordingOutputBackend<DS4Device::Report>>(1);
+  DS4Device ds4(ds4Backend);
+  const auto ds4Ns = ns_per_flush(ds4, [](auto& device, long i) {
+    device.setLXAxis(i & 0xffff)->setButton(DS4Device::Button::CROSS, i & 1);
+  });
+
+  REQUIRE(vjoyBackend->getWriteCount() > 0);
+  REQUIRE(x360Backend->getWriteCount() > 0);
+  REQUIRE(ds4Backend->getWriteCount() > 0);
+  printf(
+    "Output flush: vJoy %.1fns, X360 %.1fns, DS4 %.1fns\n",
+    vjoyNs,
+    x360Ns,
+    ds4Ns);
+}
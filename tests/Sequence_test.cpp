@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/Sequence.h>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("Sequence") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  TestButton trigger;
+  Button::Value b3(false);
+  Hat::Value hat(Hat::CENTER);
+  Axis::Value axis(Axis::MID);
+
+  Sequence sequence {
+    Sequence::press(&b3, 40ms),
+    Sequence::wait(20ms),
+    Sequence::hat(&hat, Hat::NORTH, 60ms),
+    Sequence::axis(&axis, Axis::MAX),
+    Sequence::wait(10ms),
+    Sequence::axis(&axis, Axis::MID),
+  };
+  trigger >> sequence;
+
+  REQUIRE(!sequence.isPlaying());
+  trigger.emit(true);
+  REQUIRE(sequence.isPlaying());
+  REQUIRE(b3);
+  REQUIRE(hat == Hat::CENTER);
+
+  SECTION("Plays with exact delays") {
+    clock->advance(39ms);
+    REQUIRE(b3);
+    clock->advance(1ms);
+    REQUIRE(!b3);
+    clock->advance(19ms);
+    REQUIRE(hat == Hat::CENTER);
+    clock->advance(1ms);
+    REQUIRE(hat == Hat::NORTH);
+    clock->advance(59ms);
+    REQUIRE(hat == Hat::NORTH);
+    REQUIRE(axis == Axis::MID);
+    clock->advance(1ms);
+    REQUIRE(hat == Hat::CENTER);
+    REQUIRE(axis == Axis::MAX);
+    REQUIRE(sequence.isPlaying());
+    clock->advance(10ms);
+    REQUIRE(axis == Axis::MID);
+    REQUIRE(!sequence.isPlaying());
+  }
+
+  SECTION("Only one timer at a time") {
+    REQUIRE(clock->getPendingTimerCount() == 1);
+    clock->advance(40ms);
+    REQUIRE(clock->getPendingTimerCount() == 1);
+    clock->advance(20ms);
+    REQUIRE(clock->getPendingTimerCount() == 1);
+    clock->advance(1s);
+    REQUIRE(clock->getPendingTimerCount() == 0);
+  }
+
+  SECTION("Presses while playing are ignored") {
+    trigger.emit(false);
+    clock->advance(20ms);
+    trigger.emit(true);
+    clock->advance(20ms);
+    REQUIRE(!b3);
+    REQUIRE(clock->getPendingTimerCount() == 1);
+  }
+
+  SECTION("Can be played again") {
+    trigger.emit(false);
+    clock->advance(200ms);
+    REQUIRE(!sequence.isPlaying());
+    trigger.emit(true);
+    REQUIRE(b3);
+    clock->advance(40ms);
+    REQUIRE(!b3);
+  }
+
+  SECTION("Cancel releases held buttons") {
+    clock->advance(10ms);
+    sequence.cancel();
+    REQUIRE(!b3);
+    REQUIRE(!sequence.isPlaying());
+    clock->advance(1s);
+    REQUIRE(!b3);
+    REQUIRE(hat == Hat::CENTER);
+    REQUIRE(axis == Axis::MID);
+  }
+
+  SECTION("Cancel centers held hats") {
+    clock->advance(80ms);
+    REQUIRE(hat == Hat::NORTH);
+    sequence.cancel();
+    REQUIRE(hat == Hat::CENTER);
+    clock->advance(1s);
+    REQUIRE(axis == Axis::MID);
+  }
+}
@@ -44,3 +44,125 @@ TEST_CASE("ShortPressLongPress") {
     REQUIRE(!b2);
   }
 }
+
+TEST_CASE("ShortPressLongPress at threshold") {
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  TestButton button;
+  Button::Value b1(false), b2(false);
+
+  button >> ShortPressLongPress(
+    &b1,
+    &b2,
+    std::chrono::milliseconds(300),
+    ShortPressLongPress::LongPressMode::AT_THRESHOLD);
+
+  SECTION("Short Press") {
+    button.emit(true);
+    clock->advance(std::chrono::milliseconds(100));
+    button.emit(false);
+    REQUIRE(b1);
+    REQUIRE(!b2);
+    // The threshold timer must not fire after release
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+
+  SECTION("Long Press") {
+    button.emit(true);
+    clock->advance(std::chrono::milliseconds(299));
+    REQUIRE(!b2);
+    clock->advance(std::chrono::milliseconds(1));
+    REQUIRE(!b1);
+    REQUIRE(b2);
+    clock->advance(std::chrono::milliseconds(100));
+    REQUIRE(!b2);
+    button.emit(false);
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+
+  SECTION("Short press, then a press that crosses the old threshold") {
+    button.emit(true);
+    clock->advance(std::chrono::milliseconds(150));
+    button.emit(false);
+    clock->advance(std::chrono::milliseconds(150));
+    REQUIRE(!b1);
+    button.emit(true);
+    clock->advance(std::chrono::milliseconds(150));
+    // First press's timer is stale
+    REQUIRE(!b2);
+    button.emit(false);
+    REQUIRE(b1);
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+
+  SECTION("Released at the threshold, before the timer is handled") {
+    // Added first, so handled first
+    clock->setTimer(
+      std::chrono::milliseconds(300), [&button]() { button.emit(false); });
+    button.emit(true);
+    clock->advance(std::chrono::milliseconds(300));
+    REQUIRE(!b1);
+    REQUIRE(b2);
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+}
+
+TEST_CASE("ShortPressLongPress at threshold until release") {
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  TestButton button;
+  Button::Value b1(false), b2(false);
+
+  button >> ShortPressLongPress(
+    &b1,
+    &b2,
+    std::chrono::milliseconds(300),
+    ShortPressLongPress::LongPressMode::AT_THRESHOLD_UNTIL_RELEASE);
+
+  SECTION("Short Press") {
+    button.emit(true);
+    button.emit(false);
+    REQUIRE(b1);
+    REQUIRE(!b2);
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+
+  SECTION("Long Press") {
+    button.emit(true);
+    clock->advance(std::chrono::milliseconds(300));
+    REQUIRE(b2);
+    clock->advance(std::chrono::seconds(10));
+    REQUIRE(b2);
+    button.emit(false);
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+
+  SECTION("Released at the threshold, before the timer is handled") {
+    // Added first, so handled first
+    clock->setTimer(
+      std::chrono::milliseconds(300), [&button]() { button.emit(false); });
+    button.emit(true);
+    clock->advance(std::chrono::milliseconds(300));
+    REQUIRE(!b1);
+    REQUIRE(b2);
+    clock->advance(std::chrono::seconds(1));
+    REQUIRE(!b1);
+    REQUIRE(!b2);
+  }
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/SplineCurve.h>
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+TEST_CASE("SplineCurve") {
+  long out = -1;
+  TestAxis axis;
+
+  SECTION("Straight line") {
+    axis >> SplineCurve {{Axis::MIN, Axis::MIN}, {Axis::MAX, Axis::MAX}}
+      >> &out;
+    for (long value = Axis::MIN; value <= Axis::MAX; ++value) {
+      axis.emit(value);
+      REQUIRE(out == value);
+    }
+  }
+
+  SECTION("Goes through every point without overshooting") {
+    const std::vector<SplineCurve::Point> points {
+      {Axis::MIN, Axis::MIN},
+      {0x2000, 0x0100},
+      {0x6000, 0x0200},
+      {0x7000, 0xf000},
+      {Axis::MAX, Axis::MAX},
+    };
+    axis >> SplineCurve(points) >> &out;
+    for (const auto& point: points) {
+      axis.emit(point.in);
+      REQUIRE(out == point.out);
+    }
+
+    axis.emit(Axis::MIN);
+    auto previous = out;
+    for (long value = Axis::MIN + 1; value <= Axis::MAX; ++value) {
+      axis.emit(value);
+      REQUIRE(out >= previous);
+      previous = out;
+    }
+  }
+
+  SECTION("Decreasing") {
+    axis >> SplineCurve {
+      {Axis::MIN, Axis::MAX},
+      {0x4000, 0xa000},
+      {Axis::MAX, Axis::MIN},
+    } >> &out;
+    axis.emit(Axis::MIN);
+    REQUIRE(out == Axis::MAX);
+    auto previous = out;
+    for (long value = Axis::MIN + 1; value <= Axis::MAX; ++value) {
+      axis.emit(value);
+      REQUIRE(out <= previous);
+      previous = out;
+    }
+    REQUIRE(out == Axis::MIN);
+  }
+
+  SECTION("Flat outside of the points") {
+    axis >> SplineCurve {{0x1000, 0x2000}, {0xe000, 0xd000}} >> &out;
+    axis.emit(Axis::MIN);
+    REQUIRE(out == 0x2000);
+    axis.emit(0x0fff);
+    REQUIRE(out == 0x2000);
+    axis.emit(0xe001);
+    REQUIRE(out == 0xd000);
+    axis.emit(Axis::MAX);
+    REQUIRE(out == 0xd000);
+  }
+}
+
+TEST_CASE("SplineCurve validation") {
+  using Points = std::vector<SplineCurve::Point>;
+  REQUIRE_THROWS_AS(SplineCurve(Points {}), std::invalid_argument);
+  REQUIRE_THROWS_AS(SplineCurve({{0, 0}}), std::invalid_argument);
+  // Not increasing inputs
+  REQUIRE_THROWS_AS(
+    SplineCurve({{0, 0}, {0x8000, 0x8000}, {0x8000, 0x9000}}),
+    std::invalid_argument);
+  REQUIRE_THROWS_AS(
+    SplineCurve({{0x8000, 0}, {0x4000, 0x8000}}), std::invalid_argument);
+  // Not monotonic
+  REQUIRE_THROWS_AS(
+    SplineCurve({{0, 0}, {0x8000, 0x9000}, {0xffff, 0x8000}}),
+    std::invalid_argument);
+  // Out of range
+  REQUIRE_THROWS_AS(
+    SplineCurve({{-1, 0}, {0xffff, 0xffff}}), std::invalid_argument);
+  REQUIRE_THROWS_AS(
+    SplineCurve({{0, 0}, {0xffff, 0x10000}}), std::invalid_argument);
+
+  // Flat sections are fine
+  REQUIRE_NOTHROW(SplineCurve({{0, 0}, {0x8000, 0}, {0xffff, 0xffff}}));
+}
+
+TEST_CASE("SplineCurves share tables") {
+  const auto before = SplineCurve::getTableCount();
+  {
+    SplineCurve a {{0, 0}, {0x4000, 0x1000}, {0xffff, 0xffff}};
+    REQUIRE(SplineCurve::getTableCount() == before + 1);
+    SplineCurve b {{0, 0}, {0x4000, 0x1000}, {0xffff, 0xffff}};
+    REQUIRE(SplineCurve::getTableCount() == before + 1);
+    SplineCurve c {{0, 0}, {0x4000, 0x2000}, {0xffff, 0xffff}};
+    REQUIRE(SplineCurve::getTableCount() == before + 2);
+  }
+  REQUIRE(SplineCurve::getTableCount() == before);
+}
+
+TEST_CASE("SplineCurve performance", "[.][benchmark]") {
+  using clock = std::chrono::steady_clock;
+  const long rounds = 100;
+
+  long out;
+  TestAxis axis;
+  axis >> SplineCurve {
+    {Axis::MIN, Axis::MIN},
+    {0x5000, 0x6800},
+    {Axis::MID, Axis::MID},
+    {0xafff, 0x97ff},
+    {Axis::MAX, Axis::MAX},
+  } >> &out;
+
+  uint64_t checksum = 0;
+  const auto start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    for (long value = Axis::MIN; value <= Axis::MAX; ++value) {
+      axis.emit(value);
+      checksum += out;
+    }
+  }
+  const auto elapsed = clock::now() - start;
+  REQUIRE(checksum > 0);
+
+  using namespace std::chrono;
+  printf(
+    "SplineCurve: %.1fns/event\n",
+    duration<double, std::nano>(elapsed).count() / (rounds * 0x10000));
+}
@@ -8,10 +8,43 @@
 
 #include <cpp-remapper/SquareDeadzone.h>
 
+#include <chrono>
+#include <cstdio>
+
 #include "tests.h"
 
 using namespace fredemmott::inputmapping;
 
+namespace {
+// The previous implementation, which divided on every event
+long reference_deadzone(uint8_t percent, long value) {
+  value *= 100;
+  const uint32_t MAX = 0xffff * 100;
+  const uint32_t MID = MAX / 2;
+  const uint32_t DEAD = (percent * MID) / 100;
+  if (value > (MID - DEAD) && value < (MID + DEAD)) {
+    return MID / 100;
+  }
+  const uint32_t NEW_MAX = MAX - (2 * DEAD);
+  const uint32_t without_deadzone = (value < MID) ? value : value - (2 * DEAD);
+  const uint32_t scaled = (without_deadzone * (uint64_t)MAX) / NEW_MAX;
+  return scaled / 100;
+}
+
+class ReferenceDeadzone final : public AxisSink, public AxisSource {
+ public:
+  ReferenceDeadzone(uint8_t percent) : mPercent(percent) {
+  }
+
+  virtual void map(Axis::Value value) override {
+    emit(reference_deadzone(mPercent, value));
+  }
+
+ private:
+  uint8_t mPercent;
+};
+}// namespace
+
 TEST_CASE("SquareDeadzone") {
   const auto percent = GENERATE(10_percent, 90_percent);
 
@@ -70,3 +103,68 @@ TEST_CASE("SquareDeadzone") {
   REQUIRE(out <= 0x7fff - 0x4000);
   REQUIRE(out >= 0x7fff - 0x4000 - delta_ceil);
 }
+
+TEST_CASE("SquareDeadzone matches division for all inputs") {
+  long out = -1;
+  for (uint8_t percent = 0; percent < 100; ++percent) {
+    TestAxis axis;
+    axis >> SquareDeadzone(Percent(percent)) >> &out;
+    size_t mismatches = 0;
+    for (long value = 0; value <= 0xffff; ++value) {
+      axis.emit(value);
+      if (out != reference_deadzone(percent, value)) {
+        ++mismatches;
+      }
+    }
+    CAPTURE(percent);
+    REQUIRE(mismatches == 0);
+  }
+}
+
+TEST_CASE("SquareDeadzone with 100% deadzone") {
+  long out = -1;
+  TestAxis axis;
+  axis >> SquareDeadzone(100_percent) >> &out;
+  axis.emit(0);
+  REQUIRE(out == 0x7fff);
+  axis.emit(0xffff);
+  REQUIRE(out == 0x7fff);
+}
+
+TEST_CASE("SquareDeadzone performance", "[.][benchmark]") {
+  using clock = std::chrono::steady_clock;
+  const long rounds = 100;
+
+  long out;
+  TestAxis axis;
+  axis >> SquareDeadzone(10_percent) >> &out;
+  uint64_t checksum = 0;
+  auto start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    for (long value = 0; value <= 0xffff; ++value) {
+      axis.emit(value);
+      checksum += out;
+    }
+  }
+  const auto actual = clock::now() - start;
+
+  TestAxis referenceAxis;
+  referenceAxis >> ReferenceDeadzone(10) >> &out;
+  uint64_t referenceChecksum = 0;
+  start = clock::now();
+  for (long i = 0; i < rounds; ++i) {
+    for (long value = 0; value <= 0xffff; ++value) {
+      referenceAxis.emit(value);
+      referenceChecksum += out;
+    }
+  }
+  const auto division = clock::now() - start;
+  REQUIRE(checksum == referenceChecksum);
+
+  using namespace std::chrono;
+  const auto events = rounds * 0x10000;
+  printf(
+    "SquareDeadzone: %.1fns/event; division: %.1fns/event\n",
+    duration<double, std::nano>(actual).count() / events,
+    duration<double, std::nano>(division).count() / events);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/Turbo.h>
+
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "FakeClock.h"
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+// Fires every timer up to `maxLateness` late
+class LateClock final : public FakeClock {
+ public:
+  explicit LateClock(std::chrono::milliseconds maxLateness)
+    : mLateness(0, static_cast<int>(maxLateness.count())) {
+  }
+
+  virtual void setTimer(
+    const std::chrono::steady_clock::duration& delay,
+    const std::function<void()>& handler) noexcept override {
+    FakeClock::setTimer(
+      delay + std::chrono::milliseconds(mLateness(mRandom)), handler);
+  }
+
+ private:
+  std::mt19937 mRandom {0};
+  std::uniform_int_distribution<int> mLateness;
+};
+}// namespace
+
+TEST_CASE("Turbo") {
+  using namespace std::chrono_literals;
+  auto clock = std::make_shared<FakeClock>();
+  Clock::set(clock);
+
+  TestButton button;
+  Button::Value pressed(false);
+
+  button >> Turbo(100ms, 0.25f) >> &pressed;
+  REQUIRE(!pressed);
+
+  button.emit(true);
+  REQUIRE(pressed);
+
+  SECTION("Toggles while held") {
+    clock->advance(24ms);
+    REQUIRE(pressed);
+    clock->advance(1ms);
+    REQUIRE(!pressed);
+    clock->advance(74ms);
+    REQUIRE(!pressed);
+    clock->advance(1ms);
+    REQUIRE(pressed);
+    clock->advance(25ms);
+    REQUIRE(!pressed);
+  }
+
+  SECTION("Releases immediately") {
+    clock->advance(10ms);
+    button.emit(false);
+    REQUIRE(!pressed);
+    clock->advance(1s);
+    REQUIRE(!pressed);
+    REQUIRE(clock->getPendingTimerCount() == 0);
+  }
+
+  SECTION("Restarts the cycle on the next press") {
+    clock->advance(50ms);
+    button.emit(false);
+    clock->advance(10ms);
+    button.emit(true);
+    REQUIRE(pressed);
+    clock->advance(25ms);
+    REQUIRE(!pressed);
+  }
+}
+
+TEST_CASE("Turbo validation") {
+  using namespace std::chrono_literals;
+  REQUIRE_THROWS_AS(Turbo(0ms), std::invalid_argument);
+  REQUIRE_THROWS_AS(Turbo(-1ms), std::invalid_argument);
+  REQUIRE_NOTHROW(Turbo(1ms));
+}
+
+namespace {
+using namespace std::chrono_literals;
+
+const auto MAX_LATENESS = 3ms;
+
+struct Jitter {
+  std::chrono::steady_clock::duration max {};
+  std::chrono::steady_clock::duration mean {};
+  std::chrono::steady_clock::duration last {};
+};
+
+// How late each press is compared to a perfect cadence
+Jitter get_jitter() {
+  const auto period = 20ms;
+  const int cycles = 5000;
+
+  auto clock = std::make_shared<LateClock>(MAX_LATENESS);
+  Clock::set(clock);
+
+  TestButton button;
+  std::vector<std::chrono::steady_clock::time_point> presses;
+  button >> Turbo(period) >> [&](Button::Value value) {
+    if (value) {
+      presses.push_back(clock->now());
+    }
+  };
+
+  const auto start = clock->now();
+  button.emit(true);
+  // Step by the timer resolution so that `now()` is exact in the callbacks
+  while (clock->now() - start < (period * cycles) - 1ms) {
+    clock->advance(1ms);
+  }
+  button.emit(false);
+
+  REQUIRE(presses.size() == cycles);
+  Jitter ret;
+  std::chrono::steady_clock::duration total {};
+  for (int i = 0; i < cycles; ++i) {
+    const auto jitter = presses[i] - (start + (i * period));
+    REQUIRE(jitter >= 0ms);
+    ret.max = std::max(ret.max, jitter);
+    total += jitter;
+  }
+  ret.mean = total / cycles;
+  ret.last = presses.back() - (start + ((cycles - 1) * period));
+  return ret;
+}
+}// namespace
+
+TEST_CASE("Turbo cadence with late timers") {
+  const auto jitter = get_jitter();
+  // Bounded by how late a single timer can be, however many cycles there are
+  REQUIRE(jitter.max <= MAX_LATENESS);
+  REQUIRE(jitter.mean <= MAX_LATENESS);
+  // ... and the last press isn't any later than the others
+  REQUIRE(jitter.last <= MAX_LATENESS);
+}
+
+TEST_CASE("Turbo jitter", "[.][benchmark]") {
+  const auto jitter = get_jitter();
+
+  using namespace std::chrono;
+  printf(
+    "Turbo with timers up to %lldms late: %.1fus mean jitter, %.1fus max\n",
+    static_cast<long long>(MAX_LATENESS.count()),
+    duration<double, std::micro>(jitter.mean).count(),
+    duration<double, std::micro>(jitter.max).count());
+}
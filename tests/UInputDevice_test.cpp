@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020-present, Fred Emmott <fred@fredemmott.com>
+ * All rights reserved.
+ *
+ * This source code is licensed under the ISC license found in the LICENSE file
+ * in the root directory of this source tree.
+ */
+
+#include <cpp-remapper/MappableUInputOutput.h>
+#include <cpp-remapper/UInputDevice.h>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "tests.h"
+
+using namespace fredemmott::inputmapping;
+
+namespace {
+
+class Pipe final {
+ public:
+  Pipe() {
+    REQUIRE(pipe2(mFDs, O_NONBLOCK) == 0);
+  }
+  ~Pipe() {
+    close(mFDs[0]);
+    close(mFDs[1]);
+  }
+
+  int getWriteFD() const {
+    return mFDs[1];
+  }
+
+  /// Returns the events from the next `write()`
+  std::vector<input_event> read() {
+    std::vector<input_event> events(256);
+    const auto bytes
+      = ::read(mFDs[0], events.data(), events.size() * sizeof(input_event));
+    if (bytes <= 0) {
+      return {};
+    }
+    REQUIRE(bytes % sizeof(input_event) == 0);
+    events.resize(bytes / sizeof(input_event));
+    return events;
+  }
+
+ private:
+  int mFDs[2];
+};
+
+}// namespace
+
+TEST_CASE("UInputDevice") {
+  Pipe pipe;
+  auto device = std::make_shared<UInputDevice>(pipe.getWriteFD());
+
+  // Nothing has changed yet
+  device->flush();
+  REQUIRE(pipe.read().empty());
+
+  SECTION("Changes are batched into one write") {
+    device->setXAxis(0)->setButton(1, true)->setButton(128, true);
+    device->setHat(1, Hat::SOUTH_WEST);
+    device->flush();
+
+    const auto events = pipe.read();
+    REQUIRE(events.size() == 6);
+    REQUIRE(events[0].type == EV_ABS);
+    REQUIRE(events[0].code == ABS_X);
+    REQUIRE(events[0].value == 0);
+    REQUIRE(events[1].code == ABS_HAT0X);
+    REQUIRE(events[1].value == -1);
+    REQUIRE(events[2].code == ABS_HAT0Y);
+    REQUIRE(events[2].value == 1);
+    REQUIRE(events[3].type == EV_KEY);
+    REQUIRE(events[3].code == BTN_TRIGGER);
+    REQUIRE(events[3].value == 1);
+    REQUIRE(events[4].type == EV_KEY);
+    REQUIRE(events[4].code == UInputDevice::getButtonCode(128));
+    REQUIRE(events[5].type == EV_SYN);
+    REQUIRE(events[5].code == SYN_REPORT);
+
+    // Only send what changed
+    device->setButton(1, false)->setHat(1, Hat::WEST);
+    device->flush();
+    const auto next = pipe.read();
+    REQUIRE(next.size() == 3);
+    REQUIRE(next[0].code == ABS_HAT0Y);
+    REQUIRE(next[0].value == 0);
+    REQUIRE(next[1].code == BTN_TRIGGER);
+    REQUIRE(next[1].value == 0);
+    REQUIRE(next[2].type == EV_SYN);
+
+    // Setting the same value again is not a change
+    device->setXAxis(0)->setHat(1, Hat::WEST);
+    device->flush();
+    REQUIRE(pipe.read().empty());
+  }
+
+  SECTION("Button codes are unique") {
+    std::vector<uint16_t> codes;
+    for (uint8_t i = 1; i <= UInputDevice::BUTTON_COUNT; ++i) {
+      const auto code = UInputDevice::getButtonCode(i);
+      // SDL doesn't see KEY_MAX
+      REQUIRE(code < KEY_MAX);
+      codes.push_back(code);
+    }
+    std::ranges::sort(codes);
+    REQUIRE(std::ranges::adjacent_find(codes) == codes.end());
+  }
+
+  SECTION("MappableUInputOutput") {
+    MappableUInputOutput output(device);
+    TestAxis axis;
+    TestButton button;
+    axis >> output.RZAxis;
+    button >> output.Button17;
+
+    axis.emit(1234);
+    button.emit(true);
+    output.getDevice()->flush();
+
+    const auto events = pipe.read();
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[0].code == ABS_RZ);
+    REQUIRE(events[0].value == 1234);
+    REQUIRE(events[1].code == UInputDevice::getButtonCode(17));
+    REQUIRE(events[2].type == EV_SYN);
+  }
+}